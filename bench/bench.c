@@ -0,0 +1,761 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * softfp-bench: measures the throughput (ns/op, ops/s) and the latency of every generated operation for different
+ * classes of operands, and compares them to libgcc's soft-fp routines and to the hardware where available.
+ *
+ * The list of operations is generated by `configure.sh` (bench/ops.h). libgcc's routines are loaded from libgcc_s at
+ * runtime, since some of them have the same names as the routines of this library (e.g., `__extendsftf2`).
+ */
+
+#include "softfp.h"
+
+#include <dlfcn.h>
+#include <float.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef SOFTFP_VERSION
+#define SOFTFP_VERSION "unknown"
+#endif
+
+#define NOPS 1024   // number of operands per array (power of two)
+#define MAX_SIZE 32 // size of the largest operand type
+
+enum {
+    CLS_NORMAL,
+    CLS_DENORMAL,
+    CLS_SPECIAL, // infinities and NaNs
+    CLS_CANCEL,  // operands of almost the same magnitude, such that their sum (or difference) cancels
+    CLS_INT,     // integers (for conversions to floating-point numbers)
+    NCLASSES
+};
+
+static const char *class_names[NCLASSES] = {"normal", "denormal", "special", "cancel", "int"};
+
+#define ARITH_CLASSES (1 << CLS_NORMAL | 1 << CLS_DENORMAL | 1 << CLS_SPECIAL)
+#define ADD_CLASSES (ARITH_CLASSES | 1 << CLS_CANCEL)
+#define INT_CLASSES (1 << CLS_INT)
+
+typedef struct bench bench_t;
+
+struct bench {
+    const char *op;
+    const char *impl;   // "softfp", "libgcc" or "hardware"
+    const char *src;    // format of the operands
+    const char *dst;    // format of the result (conversions between formats only)
+    unsigned classes;   // operand classes (bit mask)
+    size_t size;        // size of an operand
+    double (*run)(const bench_t *bench, const void *a, const void *b, size_t iters, bool latency);
+    const char *symbol; // name of the libgcc routine (loaded at runtime)
+    void *fn;
+};
+
+typedef struct {
+    const bench_t *bench;
+    int cls;
+    double ns;      // throughput
+    double latency; // latency
+} result_t;
+
+static double min_time = 0.01;
+
+static volatile size_t zero = 0;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* prevents the compiler from optimizing away the computation of `x` */
+#define CLOBBER(x) __asm__ volatile("" : : "g"(x) : "memory")
+
+/*
+ * defines `run_<name>`, which evaluates `expr` (using the operands `x` and `y`) `iters` times. In latency mode, the
+ * index of the next operands depends on the previous result, so subsequent operations cannot overlap.
+ */
+#define DEFINE_RUN(name, Ta, Tb, Tr, expr)                                                                             \
+    static double run_##name(const bench_t *bench, const void *va, const void *vb, size_t iters, bool latency) {       \
+        const Ta *a = va;                                                                                              \
+        const Tb *b = vb;                                                                                              \
+        static Tr r[NOPS];                                                                                             \
+        const size_t mask = zero;                                                                                      \
+        size_t i = 0;                                                                                                  \
+        (void) bench;                                                                                                  \
+                                                                                                                       \
+        double start = now();                                                                                          \
+                                                                                                                       \
+        if (latency) {                                                                                                 \
+            for (size_t k = 0; k < iters; ++k) {                                                                       \
+                Ta x = a[i];                                                                                           \
+                Tb y = b[i];                                                                                           \
+                Tr z = (expr);                                                                                         \
+                unsigned char c;                                                                                       \
+                (void) y;                                                                                              \
+                                                                                                                       \
+                memcpy(&c, &z, 1);                                                                                     \
+                i = (i + 1 + (c & mask)) & (NOPS - 1);                                                                 \
+            }                                                                                                          \
+        } else {                                                                                                       \
+            for (size_t k = 0; k < iters; k += NOPS) {                                                                 \
+                for (size_t j = 0; j < NOPS; ++j) {                                                                    \
+                    Ta x = a[j];                                                                                       \
+                    Tb y = b[j];                                                                                       \
+                    (void) y;                                                                                          \
+                                                                                                                       \
+                    r[j] = (expr);                                                                                     \
+                }                                                                                                      \
+            }                                                                                                          \
+        }                                                                                                              \
+                                                                                                                       \
+        double elapsed = now() - start;                                                                                \
+        CLOBBER(i);                                                                                                    \
+        CLOBBER(r);                                                                                                    \
+        return elapsed;                                                                                                \
+    }
+
+/***** SOFTFP *****/
+
+#define BENCH_BINARY(fmt, p, id, cid, T, CT)                                                                           \
+    DEFINE_RUN(p##add##id, T, T, T, p##add##id##3(x, y))                                                               \
+    DEFINE_RUN(p##sub##id, T, T, T, p##sub##id##3(x, y))                                                               \
+    DEFINE_RUN(p##mul##id, T, T, T, p##mul##id##3(x, y))                                                               \
+    DEFINE_RUN(p##div##id, T, T, T, p##div##id##3(x, y))                                                               \
+    DEFINE_RUN(p##fma##id, T, T, T, p##fma##id##4(x, y, x))                                                            \
+    DEFINE_RUN(p##sqrt##id, T, T, T, p##sqrt##id##2(x))                                                                \
+    DEFINE_RUN(p##cmp##id, T, T, int, p##cmp##id##2(x, y))                                                             \
+    DEFINE_RUN(p##fix##id##si, T, T, int32_t, p##fix##id##si(x))                                                       \
+    DEFINE_RUN(p##fix##id##di, T, T, int64_t, p##fix##id##di(x))                                                       \
+    DEFINE_RUN(p##floatsi##id, int32_t, int32_t, T, p##floatsi##id(x))                                                 \
+    DEFINE_RUN(p##floatdi##id, int64_t, int64_t, T, p##floatdi##id(x))                                                 \
+    DEFINE_RUN(p##mul##cid, T, T, CT, p##mul##cid##3(x, y, y, x))                                                      \
+    DEFINE_RUN(p##div##cid, T, T, CT, p##div##cid##3(x, y, y, x))
+
+#define BENCH_DECIMAL(fmt, p, id, T)                                                                                   \
+    DEFINE_RUN(p##add##id, T, T, T, p##add##id##3(x, y))                                                               \
+    DEFINE_RUN(p##sub##id, T, T, T, p##sub##id##3(x, y))                                                               \
+    DEFINE_RUN(p##mul##id, T, T, T, p##mul##id##3(x, y))                                                               \
+    DEFINE_RUN(p##div##id, T, T, T, p##div##id##3(x, y))                                                               \
+    DEFINE_RUN(p##cmp##id, T, T, int, p##cmp##id##2(x, y))                                                             \
+    DEFINE_RUN(p##fix##id##si, T, T, int32_t, p##fix##id##si(x))                                                       \
+    DEFINE_RUN(p##fix##id##di, T, T, int64_t, p##fix##id##di(x))                                                       \
+    DEFINE_RUN(p##floatsi##id, int32_t, int32_t, T, p##floatsi##id(x))                                                 \
+    DEFINE_RUN(p##floatdi##id, int64_t, int64_t, T, p##floatdi##id(x))
+
+#define BENCH_CAST(src, dst, kind, fn, Ts, Td) DEFINE_RUN(fn, Ts, Ts, Td, fn(x))
+
+#include "ops.h"
+
+#undef BENCH_BINARY
+#undef BENCH_DECIMAL
+#undef BENCH_CAST
+
+#define SOFTFP(op, fmt, classes, name, T) {op, "softfp", #fmt, NULL, classes, sizeof(T), run_##name, NULL, NULL},
+
+#define BENCH_BINARY(fmt, p, id, cid, T, CT)                                                                           \
+    SOFTFP("add", fmt, ADD_CLASSES, p##add##id, T)                                                                     \
+    SOFTFP("sub", fmt, ADD_CLASSES, p##sub##id, T)                                                                     \
+    SOFTFP("mul", fmt, ARITH_CLASSES, p##mul##id, T)                                                                   \
+    SOFTFP("div", fmt, ARITH_CLASSES, p##div##id, T)                                                                   \
+    SOFTFP("fma", fmt, ADD_CLASSES, p##fma##id, T)                                                                     \
+    SOFTFP("sqrt", fmt, ARITH_CLASSES, p##sqrt##id, T)                                                                 \
+    SOFTFP("cmp", fmt, ARITH_CLASSES, p##cmp##id, T)                                                                   \
+    SOFTFP("fixsi", fmt, ARITH_CLASSES, p##fix##id##si, T)                                                             \
+    SOFTFP("fixdi", fmt, ARITH_CLASSES, p##fix##id##di, T)                                                             \
+    SOFTFP("floatsi", fmt, INT_CLASSES, p##floatsi##id, int32_t)                                                       \
+    SOFTFP("floatdi", fmt, INT_CLASSES, p##floatdi##id, int64_t)                                                       \
+    SOFTFP("cmul", fmt, ARITH_CLASSES, p##mul##cid, T)                                                                 \
+    SOFTFP("cdiv", fmt, ARITH_CLASSES, p##div##cid, T)
+
+#define BENCH_DECIMAL(fmt, p, id, T)                                                                                   \
+    SOFTFP("add", fmt, ADD_CLASSES, p##add##id, T)                                                                     \
+    SOFTFP("sub", fmt, ADD_CLASSES, p##sub##id, T)                                                                     \
+    SOFTFP("mul", fmt, ARITH_CLASSES, p##mul##id, T)                                                                   \
+    SOFTFP("div", fmt, ARITH_CLASSES, p##div##id, T)                                                                   \
+    SOFTFP("cmp", fmt, ARITH_CLASSES, p##cmp##id, T)                                                                   \
+    SOFTFP("fixsi", fmt, ARITH_CLASSES, p##fix##id##si, T)                                                             \
+    SOFTFP("fixdi", fmt, ARITH_CLASSES, p##fix##id##di, T)                                                             \
+    SOFTFP("floatsi", fmt, INT_CLASSES, p##floatsi##id, int32_t)                                                       \
+    SOFTFP("floatdi", fmt, INT_CLASSES, p##floatdi##id, int64_t)
+
+#define BENCH_CAST(src, dst, kind, fn, Ts, Td) {#kind, "softfp", #src, #dst, ARITH_CLASSES, sizeof(Ts), run_##fn, NULL, NULL},
+
+static bench_t benches[] = {
+#include "ops.h"
+};
+
+/***** REFERENCES *****/
+
+/* the hardware operations (the types only serve as a bit container, the operands are always IEEE 754 formats) */
+#define HARDWARE(name, T)                                                                                              \
+    DEFINE_RUN(hw_add_##name, T, T, T, x + y)                                                                          \
+    DEFINE_RUN(hw_sub_##name, T, T, T, x - y)                                                                          \
+    DEFINE_RUN(hw_mul_##name, T, T, T, x * y)                                                                          \
+    DEFINE_RUN(hw_div_##name, T, T, T, x / y)                                                                          \
+    DEFINE_RUN(hw_cmp_##name, T, T, int, x < y ? -1 : x > y ? 1 : x == y ? 0 : 1)                                     \
+    DEFINE_RUN(hw_fixsi_##name, T, T, int32_t, (int32_t) x)                                                            \
+    DEFINE_RUN(hw_fixdi_##name, T, T, int64_t, (int64_t) x)                                                            \
+    DEFINE_RUN(hw_floatsi_##name, int32_t, int32_t, T, (T) x)                                                          \
+    DEFINE_RUN(hw_floatdi_##name, int64_t, int64_t, T, (T) x)
+
+#define HARDWARE_ENTRIES(fmt, name, T)                                                                                 \
+    {"add", "hardware", fmt, NULL, ADD_CLASSES, sizeof(T), run_hw_add_##name, NULL, NULL},                             \
+        {"sub", "hardware", fmt, NULL, ADD_CLASSES, sizeof(T), run_hw_sub_##name, NULL, NULL},                         \
+        {"mul", "hardware", fmt, NULL, ARITH_CLASSES, sizeof(T), run_hw_mul_##name, NULL, NULL},                       \
+        {"div", "hardware", fmt, NULL, ARITH_CLASSES, sizeof(T), run_hw_div_##name, NULL, NULL},                       \
+        {"cmp", "hardware", fmt, NULL, ARITH_CLASSES, sizeof(T), run_hw_cmp_##name, NULL, NULL},                       \
+        {"fixsi", "hardware", fmt, NULL, ARITH_CLASSES, sizeof(T), run_hw_fixsi_##name, NULL, NULL},                   \
+        {"fixdi", "hardware", fmt, NULL, ARITH_CLASSES, sizeof(T), run_hw_fixdi_##name, NULL, NULL},                   \
+        {"floatsi", "hardware", fmt, NULL, INT_CLASSES, sizeof(int32_t), run_hw_floatsi_##name, NULL, NULL},           \
+        {"floatdi", "hardware", fmt, NULL, INT_CLASSES, sizeof(int64_t), run_hw_floatdi_##name, NULL, NULL},
+
+#define HARDWARE_CAST(src, dst, kind, Ts, Td)                                                                          \
+    {kind, "hardware", src, dst, ARITH_CLASSES, sizeof(Ts), run_hw_##Ts##_##Td, NULL, NULL},
+
+HARDWARE(sf, float)
+HARDWARE(df, double)
+DEFINE_RUN(hw_float_double, float, float, double, (double) x)
+DEFINE_RUN(hw_double_float, double, double, float, (float) x)
+
+#if LDBL_MANT_DIG == 64 // x87 extended precision
+#define HAVE_BINARY80 1
+typedef long double binary80_t;
+typedef _Complex long double cbinary80_t;
+
+HARDWARE(tf, binary80_t)
+DEFINE_RUN(hw_float_binary80_t, float, float, binary80_t, (binary80_t) x)
+DEFINE_RUN(hw_double_binary80_t, double, double, binary80_t, (binary80_t) x)
+DEFINE_RUN(hw_binary80_t_float, binary80_t, binary80_t, float, (float) x)
+DEFINE_RUN(hw_binary80_t_double, binary80_t, binary80_t, double, (double) x)
+#endif
+
+/* libgcc's routines, called via `bench->fn` */
+#define LIBGCC(name, T, CT)                                                                                            \
+    DEFINE_RUN(gcc_cmul_##name, T, T, CT, ((CT(*)(T, T, T, T)) bench->fn)(x, y, y, x))
+
+#define LIBGCC_FULL(name, T)                                                                                           \
+    DEFINE_RUN(gcc_binop_##name, T, T, T, ((T(*)(T, T)) bench->fn)(x, y))                                              \
+    DEFINE_RUN(gcc_cmp_##name, T, T, int, ((int (*)(T, T)) bench->fn)(x, y))                                          \
+    DEFINE_RUN(gcc_fixsi_##name, T, T, int32_t, ((int32_t(*)(T)) bench->fn)(x))                                        \
+    DEFINE_RUN(gcc_fixdi_##name, T, T, int64_t, ((int64_t(*)(T)) bench->fn)(x))                                        \
+    DEFINE_RUN(gcc_floatsi_##name, int32_t, int32_t, T, ((T(*)(int32_t)) bench->fn)(x))                                \
+    DEFINE_RUN(gcc_floatdi_##name, int64_t, int64_t, T, ((T(*)(int64_t)) bench->fn)(x))
+
+#define LIBGCC_CAST(Ts, Td) DEFINE_RUN(gcc_##Ts##_##Td, Ts, Ts, Td, ((Td(*)(Ts)) bench->fn)(x))
+
+#define LIBGCC_ENTRY(op, src, dst, classes, run, T, symbol) {op, "libgcc", src, dst, classes, sizeof(T), run, symbol, NULL},
+
+#define LIBGCC_COMPLEX_ENTRIES(fmt, name, T, id)                                                                       \
+    LIBGCC_ENTRY("cmul", fmt, NULL, ARITH_CLASSES, run_gcc_cmul_##name, T, "__mul" #id "3")                            \
+    LIBGCC_ENTRY("cdiv", fmt, NULL, ARITH_CLASSES, run_gcc_cmul_##name, T, "__div" #id "3")
+
+#define LIBGCC_CAST_ENTRY(src, dst, kind, Ts, Td, symbol)                                                              \
+    LIBGCC_ENTRY(kind, src, dst, ARITH_CLASSES, run_gcc_##Ts##_##Td, Ts, symbol)
+
+LIBGCC(sf, float, _Complex float)
+LIBGCC(df, double, _Complex double)
+
+#ifdef HAVE_BINARY80
+LIBGCC(tf, binary80_t, cbinary80_t)
+#endif
+
+#ifdef __FLT16_MAX__
+#define HAVE_BINARY16 1
+typedef _Float16 binary16_t;
+
+LIBGCC(hf, binary16_t, _Complex _Float16)
+LIBGCC_CAST(binary16_t, float)
+LIBGCC_CAST(binary16_t, double)
+LIBGCC_CAST(float, binary16_t)
+LIBGCC_CAST(double, binary16_t)
+#ifdef HAVE_BINARY80
+LIBGCC_CAST(binary16_t, binary80_t)
+LIBGCC_CAST(binary80_t, binary16_t)
+#endif
+#endif
+
+#ifdef __FLT128_MAX__
+#define HAVE_BINARY128 1
+typedef _Float128 binary128_t;
+
+LIBGCC(xf, binary128_t, _Complex _Float128)
+LIBGCC_FULL(xf, binary128_t)
+LIBGCC_CAST(float, binary128_t)
+LIBGCC_CAST(double, binary128_t)
+LIBGCC_CAST(binary128_t, float)
+LIBGCC_CAST(binary128_t, double)
+#ifdef HAVE_BINARY80
+LIBGCC_CAST(binary80_t, binary128_t)
+LIBGCC_CAST(binary128_t, binary80_t)
+#endif
+#ifdef HAVE_BINARY16
+LIBGCC_CAST(binary16_t, binary128_t)
+LIBGCC_CAST(binary128_t, binary16_t)
+#endif
+#endif
+
+/*
+ * note that libgcc names the formats differently: binary80 is `xf` and binary128 is `tf` (instead of `tf` and `xf`).
+ * Also, there is no three-way comparison for binary128, so `__letf2` is used instead.
+ */
+static bench_t refs[] = {
+    HARDWARE_ENTRIES("binary32", sf, float)
+    HARDWARE_ENTRIES("binary64", df, double)
+    HARDWARE_CAST("binary32", "binary64", "extend", float, double)
+    HARDWARE_CAST("binary64", "binary32", "trunc", double, float)
+    LIBGCC_COMPLEX_ENTRIES("binary32", sf, float, sc)
+    LIBGCC_COMPLEX_ENTRIES("binary64", df, double, dc)
+#ifdef HAVE_BINARY80
+    HARDWARE_ENTRIES("binary80", tf, binary80_t)
+    HARDWARE_CAST("binary32", "binary80", "extend", float, binary80_t)
+    HARDWARE_CAST("binary64", "binary80", "extend", double, binary80_t)
+    HARDWARE_CAST("binary80", "binary32", "trunc", binary80_t, float)
+    HARDWARE_CAST("binary80", "binary64", "trunc", binary80_t, double)
+    LIBGCC_COMPLEX_ENTRIES("binary80", tf, binary80_t, xc)
+#endif
+#ifdef HAVE_BINARY16
+    LIBGCC_COMPLEX_ENTRIES("binary16", hf, binary16_t, hc)
+    LIBGCC_CAST_ENTRY("binary16", "binary32", "extend", binary16_t, float, "__extendhfsf2")
+    LIBGCC_CAST_ENTRY("binary16", "binary64", "extend", binary16_t, double, "__extendhfdf2")
+    LIBGCC_CAST_ENTRY("binary32", "binary16", "trunc", float, binary16_t, "__truncsfhf2")
+    LIBGCC_CAST_ENTRY("binary64", "binary16", "trunc", double, binary16_t, "__truncdfhf2")
+#ifdef HAVE_BINARY80
+    LIBGCC_CAST_ENTRY("binary16", "binary80", "extend", binary16_t, binary80_t, "__extendhfxf2")
+    LIBGCC_CAST_ENTRY("binary80", "binary16", "trunc", binary80_t, binary16_t, "__truncxfhf2")
+#endif
+#endif
+#ifdef HAVE_BINARY128
+    LIBGCC_ENTRY("add", "binary128", NULL, ADD_CLASSES, run_gcc_binop_xf, binary128_t, "__addtf3")
+    LIBGCC_ENTRY("sub", "binary128", NULL, ADD_CLASSES, run_gcc_binop_xf, binary128_t, "__subtf3")
+    LIBGCC_ENTRY("mul", "binary128", NULL, ARITH_CLASSES, run_gcc_binop_xf, binary128_t, "__multf3")
+    LIBGCC_ENTRY("div", "binary128", NULL, ARITH_CLASSES, run_gcc_binop_xf, binary128_t, "__divtf3")
+    LIBGCC_ENTRY("cmp", "binary128", NULL, ARITH_CLASSES, run_gcc_cmp_xf, binary128_t, "__letf2")
+    LIBGCC_ENTRY("fixsi", "binary128", NULL, ARITH_CLASSES, run_gcc_fixsi_xf, binary128_t, "__fixtfsi")
+    LIBGCC_ENTRY("fixdi", "binary128", NULL, ARITH_CLASSES, run_gcc_fixdi_xf, binary128_t, "__fixtfdi")
+    LIBGCC_ENTRY("floatsi", "binary128", NULL, INT_CLASSES, run_gcc_floatsi_xf, int32_t, "__floatsitf")
+    LIBGCC_ENTRY("floatdi", "binary128", NULL, INT_CLASSES, run_gcc_floatdi_xf, int64_t, "__floatditf")
+    LIBGCC_COMPLEX_ENTRIES("binary128", xf, binary128_t, tc)
+    LIBGCC_CAST_ENTRY("binary32", "binary128", "extend", float, binary128_t, "__extendsftf2")
+    LIBGCC_CAST_ENTRY("binary64", "binary128", "extend", double, binary128_t, "__extenddftf2")
+    LIBGCC_CAST_ENTRY("binary128", "binary32", "trunc", binary128_t, float, "__trunctfsf2")
+    LIBGCC_CAST_ENTRY("binary128", "binary64", "trunc", binary128_t, double, "__trunctfdf2")
+#ifdef HAVE_BINARY80
+    LIBGCC_CAST_ENTRY("binary80", "binary128", "extend", binary80_t, binary128_t, "__extendxftf2")
+    LIBGCC_CAST_ENTRY("binary128", "binary80", "trunc", binary128_t, binary80_t, "__trunctfxf2")
+#endif
+#ifdef HAVE_BINARY16
+    LIBGCC_CAST_ENTRY("binary16", "binary128", "extend", binary16_t, binary128_t, "__extendhftf2")
+    LIBGCC_CAST_ENTRY("binary128", "binary16", "trunc", binary128_t, binary16_t, "__trunctfhf2")
+#endif
+#endif
+};
+
+/***** OPERANDS *****/
+
+typedef struct {
+    unsigned bits;
+    bool decimal;
+    bool dpd;
+    unsigned exp;  // exponent bits (binary) or combination field bits (decimal)
+    unsigned jbit; // explicit J-bit (binary)
+    unsigned frac; // fraction bits (binary) or trailing significand bits (decimal)
+} format_t;
+
+static bool parse_format(const char *name, format_t *f) {
+    static const format_t binary[] = {
+        {16, false, false, 5, 0, 10},   {32, false, false, 8, 0, 23},    {64, false, false, 11, 0, 52},
+        {80, false, false, 15, 1, 63},  {128, false, false, 15, 0, 112}, {256, false, false, 19, 0, 236},
+    };
+    static const format_t decimal[] = {
+        {32, true, false, 11, 0, 20},
+        {64, true, false, 13, 0, 50},
+        {128, true, false, 17, 0, 110},
+    };
+
+    unsigned bits;
+
+    if (sscanf(name, "binary%u", &bits) == 1) {
+        for (size_t i = 0; i < sizeof binary / sizeof *binary; ++i) {
+            if (binary[i].bits == bits) {
+                *f = binary[i];
+                return true;
+            }
+        }
+    } else if (sscanf(name, "decimal%u", &bits) == 1) {
+        for (size_t i = 0; i < sizeof decimal / sizeof *decimal; ++i) {
+            if (decimal[i].bits == bits) {
+                *f = decimal[i];
+                f->dpd = strstr(name, "-dpd") != NULL;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static uint64_t rng;
+
+/* xorshift64* */
+static uint64_t rnd(void) {
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+/* stores the `n` (<= 64) lower bits of `x` at bit `pos` of `v` */
+static void put_bits(uint8_t *v, unsigned pos, unsigned n, uint64_t x) {
+    for (unsigned k = 0; k < n; ++k)
+        if ((x >> k) & 1)
+            v[(pos + k) / 8] |= 1 << ((pos + k) % 8);
+}
+
+static void put_random(uint8_t *v, unsigned pos, unsigned n) {
+    while (n) {
+        unsigned k = n < 64 ? n : 64;
+        put_bits(v, pos, k, rnd());
+        pos += k;
+        n -= k;
+    }
+}
+
+static void gen_binary(uint8_t *v, const format_t *f, int cls) {
+    const uint64_t bias = ((uint64_t) 1 << (f->exp - 1)) - 1;
+    const unsigned expos = f->frac + f->jbit;
+
+    switch (cls) {
+        case CLS_NORMAL:
+        case CLS_CANCEL: {
+            // exponents close to 0, such that the results are usually normal as well
+            uint64_t range = bias - 1 < 16 ? bias - 1 : 16;
+
+            put_bits(v, expos, f->exp, bias - range + rnd() % (2 * range + 1));
+            put_random(v, 0, f->frac);
+            put_bits(v, f->frac, f->jbit, 1);
+            break;
+        }
+
+        case CLS_DENORMAL:
+            put_random(v, 0, f->frac);
+            put_bits(v, 0, 1, 1);
+            break;
+
+        case CLS_SPECIAL:
+            put_bits(v, expos, f->exp, 2 * bias + 1);
+            put_bits(v, f->frac, f->jbit, 1);
+
+            if (rnd() & 1) { // quiet NaN (otherwise infinity)
+                put_random(v, 0, f->frac - 1);
+                put_bits(v, f->frac - 1, 1, 1);
+            }
+            break;
+    }
+
+    put_bits(v, f->bits - 1, 1, rnd());
+}
+
+static void gen_decimal(uint8_t *v, const format_t *f, int cls) {
+    const unsigned expbits = f->exp - 3;
+    const uint64_t expmid = (uint64_t) 3 << (expbits - 3); // the biased exponent is less than 3 * 2^(expbits - 2)
+
+    switch (cls) {
+        case CLS_NORMAL:
+        case CLS_CANCEL:
+        case CLS_DENORMAL: {
+            // denormal: smallest exponent and only three digits
+            bool denormal = cls == CLS_DENORMAL;
+            uint64_t exp = denormal ? 0 : expmid - 8 + rnd() % 17;
+
+            if (f->dpd) {
+                // S EE DDD EEE...E TTT...T (leading digit D < 8, every declet T encodes three digits < 8)
+                for (unsigned k = 0; k < f->frac / 10; ++k)
+                    put_bits(v, 10 * k, 10, denormal && k ? 0 : rnd() & 0x3F7);
+
+                put_bits(v, f->frac, expbits - 2, exp);
+                put_bits(v, f->frac + expbits - 2, 3, denormal ? 0 : rnd() & 7);
+                put_bits(v, f->frac + expbits + 1, 2, exp >> (expbits - 2));
+            } else {
+                // S EEE...E TTT...T (the coefficient T has less than `frac + 3` bits, so it is always canonical)
+                if (denormal)
+                    put_bits(v, 0, 10, rnd() % 1000);
+                else
+                    put_random(v, 0, f->frac + 3);
+
+                put_bits(v, f->frac + 3, expbits, exp);
+            }
+            break;
+        }
+
+        case CLS_SPECIAL: // S 11110 (infinity) or S 11111 0 (quiet NaN)
+            put_bits(v, f->bits - 6, 5, (rnd() & 1) ? 0x1E : 0x1F);
+            break;
+    }
+
+    put_bits(v, f->bits - 1, 1, rnd());
+}
+
+static void gen_int(uint8_t *v, size_t size) {
+    // logarithmically distributed magnitudes
+    uint64_t x = rnd() >> (rnd() % 64);
+
+    if (size == 4)
+        x >>= 32;
+
+    if (rnd() & 1)
+        x = -x;
+
+    memcpy(v, &x, size);
+}
+
+/* generates the operands `a` and `b` (NOPS each) for `bench` and the class `cls` */
+static bool gen_operands(const bench_t *bench, int cls, uint8_t *a, uint8_t *b) {
+    format_t f;
+
+    if (cls != CLS_INT && !parse_format(bench->src, &f))
+        return false;
+
+    // the same operands for all implementations
+    rng = 0x9E3779B97F4A7C15ULL * (cls + 1);
+
+    for (const char *c = bench->src; *c; ++c)
+        rng = (rng ^ (uint8_t) *c) * 0x100000001B3ULL;
+
+    memset(a, 0, NOPS * bench->size);
+    memset(b, 0, NOPS * bench->size);
+
+    for (size_t i = 0; i < NOPS; ++i) {
+        uint8_t *x = &a[i * bench->size];
+        uint8_t *y = &b[i * bench->size];
+
+        if (cls == CLS_INT) {
+            gen_int(x, bench->size);
+            gen_int(y, bench->size);
+        } else if (f.decimal) {
+            gen_decimal(x, &f, cls);
+            gen_decimal(y, &f, cls);
+        } else {
+            gen_binary(x, &f, cls);
+            gen_binary(y, &f, cls);
+        }
+
+        if (cls == CLS_CANCEL) {
+            // y = -x (x for subtraction), except for the lowest few bits
+            memcpy(y, x, bench->size);
+            y[0] ^= rnd() & 0x7;
+
+            if (strcmp(bench->op, "sub"))
+                y[(f.bits - 1) / 8] ^= 1 << ((f.bits - 1) % 8);
+        }
+    }
+
+    return true;
+}
+
+/***** MEASUREMENT *****/
+
+/* returns the time per operation in nanoseconds */
+static double measure(const bench_t *bench, const void *a, const void *b, bool latency) {
+    size_t iters = NOPS;
+    double t;
+
+    // calibrate the number of iterations
+    while ((t = bench->run(bench, a, b, iters, latency)) < min_time / 4 && iters < ((size_t) 1 << 40))
+        iters *= 2;
+
+    iters *= 4;
+
+    // best of three
+    double best = t * 4;
+
+    for (int i = 0; i < 3; ++i) {
+        t = bench->run(bench, a, b, iters, latency);
+
+        if (t < best)
+            best = t;
+    }
+
+    return best / iters * 1e9;
+}
+
+static void format_name(char *buf, size_t n, const bench_t *bench) {
+    if (bench->dst)
+        snprintf(buf, n, "%s->%s", bench->src, bench->dst);
+    else
+        snprintf(buf, n, "%s", bench->src);
+}
+
+/* finds the reference result for `res` */
+static const result_t *find_ref(const result_t *results, size_t n, const result_t *res) {
+    const bench_t *bench = res->bench;
+
+    for (size_t i = 0; i < n; ++i) {
+        const bench_t *ref = results[i].bench;
+
+        if (results[i].cls == res->cls && !strcmp(ref->op, bench->op) && !strcmp(ref->src, bench->src) &&
+            (ref->dst == NULL) == (bench->dst == NULL) && (!ref->dst || !strcmp(ref->dst, bench->dst)) &&
+            strcmp(ref->impl, "softfp"))
+            return &results[i];
+    }
+
+    return NULL;
+}
+
+static void write_json(FILE *fp, const result_t *results, size_t n) {
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"library\": \"softfp\",\n");
+    fprintf(fp, "  \"version\": \"%s\",\n", SOFTFP_VERSION);
+    fprintf(fp, "  \"min_time\": %g,\n", min_time);
+    fprintf(fp, "  \"operands\": %d,\n", NOPS);
+    fprintf(fp, "  \"results\": [\n");
+
+    for (size_t i = 0; i < n; ++i) {
+        const result_t *res = &results[i];
+        char name[64];
+
+        format_name(name, sizeof name, res->bench);
+
+        fprintf(fp,
+                "    {\"op\": \"%s\", \"format\": \"%s\", \"class\": \"%s\", \"impl\": \"%s\", \"ns_per_op\": %.3f, "
+                "\"ops_per_sec\": %.0f, \"latency_ns\": %.3f}%s\n",
+                res->bench->op, name, class_names[res->cls], res->bench->impl, res->ns, 1e9 / res->ns, res->latency,
+                i + 1 < n ? "," : "");
+    }
+
+    fprintf(fp, "  ]\n}\n");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [options]\n", prog);
+    fprintf(stderr, "  --time <seconds>  minimum time per measurement (default: %g)\n", min_time);
+    fprintf(stderr, "  --filter <text>   only run operations whose name contains <text> (e.g., \"add binary32\")\n");
+    fprintf(stderr, "  --json <file>     write the results to <file> as JSON\n");
+    fprintf(stderr, "  --no-ref          don't measure libgcc and the hardware\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = NULL;
+    const char *json = NULL;
+    bool noref = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--time") && i + 1 < argc)
+            min_time = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+            filter = argv[++i];
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc)
+            json = argv[++i];
+        else if (!strcmp(argv[i], "--no-ref"))
+            noref = true;
+        else {
+            usage(argv[0]);
+            return !!strcmp(argv[i], "--help");
+        }
+    }
+
+    const size_t nrefs = sizeof refs / sizeof *refs;
+    const size_t nbenches = sizeof benches / sizeof *benches;
+
+    void *libgcc = noref ? NULL : dlopen("libgcc_s.so.1", RTLD_NOW | RTLD_LOCAL);
+
+    for (size_t i = 0; i < nrefs; ++i)
+        if (refs[i].symbol && libgcc)
+            refs[i].fn = dlsym(libgcc, refs[i].symbol);
+
+    // the references are measured first, so the results of this library can be compared to them right away
+
+    const bench_t **all = malloc((nrefs + nbenches) * sizeof *all);
+    result_t *results = malloc((nrefs + nbenches) * NCLASSES * sizeof *results);
+    size_t nall = 0, nresults = 0;
+
+    for (size_t i = 0; i < nrefs && !noref; ++i)
+        if (!refs[i].symbol || refs[i].fn)
+            all[nall++] = &refs[i];
+
+    for (size_t i = 0; i < nbenches; ++i)
+        all[nall++] = &benches[i];
+
+    static uint8_t a[NOPS * MAX_SIZE], b[NOPS * MAX_SIZE];
+
+    printf("%-8s %-28s %-9s %-9s %12s %14s %12s\n", "op", "format", "class", "impl", "ns/op", "ops/s", "latency/ns");
+
+    for (size_t i = 0; i < nall; ++i) {
+        const bench_t *bench = all[i];
+        char name[64], full[96];
+
+        format_name(name, sizeof name, bench);
+        snprintf(full, sizeof full, "%s %s", bench->op, name);
+
+        if (filter && !strstr(full, filter))
+            continue;
+
+        for (int cls = 0; cls < NCLASSES; ++cls) {
+            if (!(bench->classes & (1 << cls)) || !gen_operands(bench, cls, a, b))
+                continue;
+
+            result_t *res = &results[nresults++];
+
+            res->bench = bench;
+            res->cls = cls;
+            res->ns = measure(bench, a, b, false);
+            res->latency = measure(bench, a, b, true);
+
+            printf("%-8s %-28s %-9s %-9s %12.2f %14.0f %12.2f", bench->op, name, class_names[cls], bench->impl,
+                   res->ns, 1e9 / res->ns, res->latency);
+
+            const result_t *ref = strcmp(bench->impl, "softfp") ? NULL : find_ref(results, nresults, res);
+
+            if (ref)
+                printf("   %6.2fx %s", res->ns / ref->ns, ref->bench->impl);
+
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    if (json) {
+        FILE *fp = fopen(json, "w");
+
+        if (!fp) {
+            perror(json);
+            return 1;
+        }
+
+        write_json(fp, results, nresults);
+        fclose(fp);
+    }
+
+    free(all);
+    free(results);
+
+    if (libgcc)
+        dlclose(libgcc);
+
+    return 0;
+}
@@ -6,3 +6,5 @@ rm -rf build
 rm -rf src/config/*.h
 rm -rf src/impl/*.c
 rm -rf include/softfp.h
+rm -rf bench/ops.h
+rm -rf include/softfp_inline.h
@@ -14,6 +14,14 @@ make_complex_type() {
     fi
 }
 
+# exact accumulator: two's complement fixed-point number covering all products (from the square of the smallest
+# denormal up to the square of the largest finite value), plus 64 bits of headroom for carries
+make_acc_type() {
+    bias=$(( (1 << ($2 - 1)) - 1 ))
+    printf "struct { uint64_t _[%d]; sbinary%s_t _nan; uint8_t _flags; uint8_t _status; }" \
+        $(( (4 * bias + 2 * $3 + 64 + 63) / 64 )) $1
+}
+
 COL1="\e[20G"
 COL2="\e[31G"
 COL3="\e[55G"
@@ -38,6 +46,7 @@ BIN80_SIZE=80
 REPR_DEC=both
 
 NO_CMAKE=0
+INLINE=0
 
 NEED_IMMINTRIN=0
 
@@ -360,6 +369,9 @@ while [[ $# -gt 0 ]]; do
     --no-fenv)
         NO_FENV=1
         ;;
+    --inline)
+        INLINE=1
+        ;;
     --print)
         prnt_info "Current configuration:"
         prnt_info "type${COL1}mode${COL2}type${COL3}complex type"
@@ -416,6 +428,7 @@ while [[ $# -gt 0 ]]; do
         OPT_DEC_REPR="`mkopt "dec-repr=<${BL}both|${BL}bid|${BL}dpd>"`"
         OPT_NO_CMAKE="`mkopt no-cmake`"
         OPT_NO_FENV="`mkopt no-fenv`"
+        OPT_INLINE="`mkopt inline`"
         OPT_PRINT="`mkopt print`"
         OPT_HELP="`mkopt help`"
 
@@ -473,6 +486,9 @@ while [[ $# -gt 0 ]]; do
         echo -e " $OPT_NO_CMAKE$RS              Don't create a build dir and run cmake"
         echo -e " $OPT_NO_FENV$RS               Don't use the standard floating-point environment"
         echo -e "$SPC provided by $BL<fenv.h>$RS"
+        echo -e " $OPT_INLINE$RS                Also generate $BL<softfp_inline.h>$RS, which defines"
+        echo -e "$SPC all functions as ${MA}static inline$RS (prefixed with"
+        echo -e "$SPC 'softfp_' instead of '__')"
         echo -e " $OPT_PRINT$RS                 Print the selected config and exit"
         echo -e " $OPT_HELP$RS                  Print this help and exit"
 
@@ -491,6 +507,7 @@ mkdir -p configure-tmp
 cd configure-tmp
 
 touch typedefs.h
+touch bench.h
 
 if [[ $NEED_IMMINTRIN -ne 0 ]]; then
     echo -e "#include <immintrin.h>\n" >> typedefs.h
@@ -507,16 +524,21 @@ gen_typedef() {
             echo "typedef $4 sc$5${1}_t;" >> typedefs.h
         fi
 
+        if [[ "$5" == "binary" ]] && [[ $2 -eq $MODE_FULL ]]; then
+            echo "typedef `make_acc_type $1 $6 $7` sacc$5${1}_t;" >> typedefs.h
+        fi
+
         echo >> typedefs.h
     fi
 }
 
-gen_typedef 16  $MODE_BIN16  "$TYPE_BIN16"  "$CTYPE_BIN16"  binary
-gen_typedef 32  $MODE_BIN32  "$TYPE_BIN32"  "$CTYPE_BIN32"  binary
-gen_typedef 64  $MODE_BIN64  "$TYPE_BIN64"  "$CTYPE_BIN64"  binary
-gen_typedef 80  $MODE_BIN80  "$TYPE_BIN80"  "$CTYPE_BIN80"  binary
-gen_typedef 128 $MODE_BIN128 "$TYPE_BIN128" "$CTYPE_BIN128" binary
-gen_typedef 256 $MODE_BIN256 "$TYPE_BIN256" "$CTYPE_BIN256" binary
+#           bits mode         type            complex type    kind    exp frac
+gen_typedef 16  $MODE_BIN16  "$TYPE_BIN16"  "$CTYPE_BIN16"  binary  5   10
+gen_typedef 32  $MODE_BIN32  "$TYPE_BIN32"  "$CTYPE_BIN32"  binary  8   23
+gen_typedef 64  $MODE_BIN64  "$TYPE_BIN64"  "$CTYPE_BIN64"  binary  11  52
+gen_typedef 80  $MODE_BIN80  "$TYPE_BIN80"  "$CTYPE_BIN80"  binary  15  63
+gen_typedef 128 $MODE_BIN128 "$TYPE_BIN128" "$CTYPE_BIN128" binary  15  112
+gen_typedef 256 $MODE_BIN256 "$TYPE_BIN256" "$CTYPE_BIN256" binary  19  236
 gen_typedef 32  $MODE_DEC32  "$TYPE_DEC32"  ""              decimal
 gen_typedef 64  $MODE_DEC64  "$TYPE_DEC64"  ""              decimal
 gen_typedef 128 $MODE_DEC128 "$TYPE_DEC128" ""              decimal
@@ -596,6 +618,9 @@ gen_truncextend() {
             echo "/** @brief converts \`a\` into a s$target_kind${target_bits}_t */" >> functions.h
             echo "s$target_kind${target_bits}_t $prefix$fnkind$id${target_id}2(s$kind${bits}_t a);" >> functions.h
             echo >> functions.h
+            echo "/** @brief converts the \`n\` elements of \`a\` into s$target_kind${target_bits}_t each */" >> functions.h
+            echo "void $prefix$fnkind$id${target_id}2_n(s$target_kind${target_bits}_t *dst, const s$kind${bits}_t *a, size_t n);" >> functions.h
+            echo >> functions.h
         done
     done
 }
@@ -612,18 +637,36 @@ gen_functions() {
         for prefix in `gen_decimal_prefix $kind`; do
 
             # convert __X_ to X
-            readable_prefix=${prefix%_}
-            readable_prefix=${readable_prefix#__}
+            readable_prefix=${prefix#__}
+            readable_prefix=${readable_prefix%_}
 
             echo -e "\n\n/* $kind$bits $readable_prefix */" >> functions.h
 
             cat ../template/functions.template.h >> functions.h
             process_template functions.h T "s$kind${bits}_t" I $id P "$prefix"
 
+            # the variants with explicit rounding modes or status words, the batch functions and sorting only exist in
+            # libsoftfp itself (cast-only formats use libgcc)
+            if [[ $2 -eq $MODE_FULL ]]; then
+                cat ../template/functions.full.template.h >> functions.h
+                process_template functions.h T "s$kind${bits}_t" I $id P "$prefix"
+            fi
+
             if [[ "$kind" == "binary" ]]; then
                 cat ../template/complex.template.h >> functions.h
                 process_template functions.h T "s$kind${bits}_t" C "sc$kind${bits}_t" I $cid
             fi
+
+            if [[ "$kind" == "binary" ]] && [[ $2 -eq $MODE_FULL ]]; then
+                cat ../template/binary.template.h >> functions.h
+                process_template functions.h T "s$kind${bits}_t" I $id
+
+                cat ../template/complex.full.template.h >> functions.h
+                process_template functions.h T "s$kind${bits}_t" I $cid
+
+                cat ../template/accumulator.template.h >> functions.h
+                process_template functions.h T "s$kind${bits}_t" A "sacc$kind${bits}_t" I $id
+            fi
         done
 
         if [[ "$kind" == "decimal" ]] && [[ "$REPR_DEC" == "both" ]]; then
@@ -663,7 +706,7 @@ gen_filename() {
     if [[ "$7" != "decimal" ]]; then
         suffix=""
     else
-        gen_isdpd $@
+        gen_isdpd "$@"
         if [[ $? -eq 0 ]]; then
             suffix="-dpd"
         else
@@ -675,7 +718,7 @@ gen_filename() {
 }
 
 gen_truncextend_impls() {
-    prefix=$1
+    source_prefix=$1
     shift
 
     bits=$1
@@ -700,19 +743,30 @@ gen_truncextend_impls() {
             fnkind="trunc"
         fi
 
-        if [[ "$kind" == "decimal" ]]; then
-            prefixes="$prefix"
+        if [[ "$kind" == "decimal" ]] && [[ -n "$source_prefix" ]]; then
+            prefixes="__${source_prefix}_"
+        elif [[ "$kind" == "decimal" ]]; then
+            prefixes="__"
         else
             prefixes=`gen_decimal_prefix $target_kind`
         fi
 
         for prefix in $prefixes; do
-            readable_prefix=${prefix%_}
-            readable_prefix=${readable_prefix#__}
+            readable_prefix=${prefix#__}
+            readable_prefix=${readable_prefix%_}
             filename=`gen_filename "$readable_prefix" $@`
 
             echo "#include \"../config/$filename.h\"" >> impl.h
             echo "#include \"../common.h\"" >> impl.h
+
+            if [[ "$readable_prefix" == "dpd" ]] || [[ "$readable_prefix" == "bid" ]]; then
+                fnprefix="__${readable_prefix}_"
+            else
+                fnprefix="__"
+            fi
+
+            echo "BENCH_CAST($bench_source, $filename, $fnkind, $fnprefix$fnkind$id${target_id}2," \
+                "s$kind${bits}_t, s$target_kind${target_bits}_t)" >> bench.h
         done
 
         shift 11
@@ -726,8 +780,8 @@ gen_impls() {
         for prefix in `gen_decimal_prefix $6`; do
 
             # convert __X_ to X
-            readable_prefix=${prefix%_}
-            readable_prefix=${readable_prefix#__}
+            readable_prefix=${prefix#__}
+            readable_prefix=${readable_prefix%_}
 
             filename=`gen_filename "$readable_prefix" $@`
             cfgfile=../src/config/$filename.h
@@ -739,10 +793,16 @@ gen_impls() {
             gen_isdpd "$readable_prefix" $@
             dpd=$((1-$?))
 
+            if [[ "$REPR_DEC" == "both" ]]; then
+                both=1
+            else
+                both=0
+            fi
+
             process_template config.h\
                 B $1 M $2 I $3 CX $5\
                 FE $7 FJ $8 FF $9 FC $4\
-                DC ${10} DS ${11} DR "$dpd"
+                DC ${10} DS ${11} DR "$dpd" DB "$both"
 
             cp -f config.h $cfgfile
 
@@ -750,9 +810,22 @@ gen_impls() {
             echo "#include \"../config/$filename.h\"" >> impl.h
             echo "#include \"../common.h\"" >> impl.h
 
+            bench_source=$filename
+
+            if [[ $2 -eq $MODE_FULL ]] && [[ "$6" == "binary" ]]; then
+                echo "BENCH_BINARY($filename, __, $3, $4, s$6$1_t, sc$6$1_t)" >> bench.h
+            elif [[ $2 -eq $MODE_FULL ]]; then
+                echo "BENCH_DECIMAL($filename, $prefix, $3, s$6$1_t)" >> bench.h
+            fi
+
             gen_truncextend_impls "$readable_prefix" $@ $IMPL_ALL
 
             cp -f impl.h $implfile
+
+            if [[ $INLINE -eq 1 ]]; then
+                grep '^#include' impl.h | sed -e 's|"\.\./|"../src/|' >> inline.h
+                echo "#include \"../src/source_reset.h\"" >> inline.h
+            fi
         done
     fi
 }
@@ -791,6 +864,23 @@ gen_impls $IMPL_DEC32
 gen_impls $IMPL_DEC64
 gen_impls $IMPL_DEC128
 
+mkdir -p ../bench
+cat ../template/license.template.h > ../bench/ops.h
+cat bench.h >> ../bench/ops.h
+
+if [[ $INLINE -eq 1 ]]; then
+    prnt_info "Generating inline header..."
+
+    cat ../template/license.template.h > ../include/softfp_inline.h
+    echo -e "#pragma once\n" >> ../include/softfp_inline.h
+    echo -e "#include \"softfp.h\"\n" >> ../include/softfp_inline.h
+    cat ../template/inline.template.h >> ../include/softfp_inline.h
+    echo "#define SOFTFP_INLINE 1" >> ../include/softfp_inline.h
+    cat inline.h >> ../include/softfp_inline.h
+    echo "#undef SOFTFP_INLINE" >> ../include/softfp_inline.h
+    echo -e "\n#pragma GCC diagnostic pop" >> ../include/softfp_inline.h
+fi
+
 cd ..
 rm -rf configure-tmp
 
@@ -0,0 +1,183 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lsp.h"
+#include "misc/half.h"
+#include "misc/pool.h"
+
+/*
+ * batch variants of the operations, which apply the operation to `n` consecutive elements. The rounding mode is read
+ * once per call and the exceptions of all elements are collected in a single status word, which is merged into the
+ * floating-point environment at the end. The output array may be the same as (one of) the input arrays.
+ *
+ * The elements are processed by a chunk function, which is called either once for the whole batch or, if the thread
+ * pool is enabled, for chunks of the batch in multiple threads (see misc/pool.h).
+ */
+
+#define FBATCH_ARITHMETIC(name, op)                                                                                    \
+    static void FBATCH_CHUNK(name)(void *arg, size_t lo, size_t hi, uint8_t *status) {                                 \
+        const softfp_batch_t *job = arg;                                                                               \
+        const fsrc_t *a = job->a, *b = job->b;                                                                         \
+        fsrc_t *dst = job->dst;                                                                                        \
+                                                                                                                       \
+        for (size_t i = lo; i < hi; ++i)                                                                               \
+            dst[i] = op(a[i], b[i], job->rm, status);                                                                  \
+    }                                                                                                                  \
+                                                                                                                       \
+    __FPFUN_LINKAGE void name(fsrc_t *dst, const fsrc_t *a, const fsrc_t *b, size_t n) {                               \
+        FBATCH_RUN(name, sizeof *dst, dst, a, b, NULL, fegetround());                                                  \
+    }
+
+#define FBATCH_FIX(name, op, type)                                                                                     \
+    static void FBATCH_CHUNK(name)(void *arg, size_t lo, size_t hi, uint8_t *status) {                                 \
+        const softfp_batch_t *job = arg;                                                                               \
+        const fsrc_t *a = job->a;                                                                                      \
+        type *dst = job->dst;                                                                                          \
+                                                                                                                       \
+        for (size_t i = lo; i < hi; ++i)                                                                               \
+            dst[i] = op(a[i], status);                                                                                 \
+    }                                                                                                                  \
+                                                                                                                       \
+    __FPFUN_LINKAGE void name(type *dst, const fsrc_t *a, size_t n) {                                                  \
+        FBATCH_RUN(name, MAX(sizeof *dst, sizeof *a), dst, a, NULL, NULL, 0);                                          \
+    }
+
+#define FBATCH_FLOAT(name, op, type)                                                                                   \
+    static void FBATCH_CHUNK(name)(void *arg, size_t lo, size_t hi, uint8_t *status) {                                 \
+        const softfp_batch_t *job = arg;                                                                               \
+        const type *a = job->a;                                                                                        \
+        fsrc_t *dst = job->dst;                                                                                        \
+                                                                                                                       \
+        for (size_t i = lo; i < hi; ++i)                                                                               \
+            dst[i] = op(a[i], job->rm, status);                                                                        \
+    }                                                                                                                  \
+                                                                                                                       \
+    __FPFUN_LINKAGE void name(fsrc_t *dst, const type *a, size_t n) {                                                  \
+        FBATCH_RUN(name, MAX(sizeof *dst, sizeof *a), dst, a, NULL, NULL, fegetround());                               \
+    }
+
+#if FDEC == 0 && FBITS == 16 && SOFTFP_HALF_SIMD == 1
+
+/* binary16 is processed by the lane-parallel kernels in misc/half.c */
+#define FBATCH_HALF(name, kernel)                                                                                      \
+    static void FBATCH_CHUNK(name)(void *arg, size_t lo, size_t hi, uint8_t *status) {                                 \
+        const softfp_batch_t *job = arg;                                                                               \
+        const fsrc_t *a = job->a, *b = job->b;                                                                         \
+        fsrc_t *dst = job->dst;                                                                                        \
+                                                                                                                       \
+        *status |= kernel(dst + lo, a + lo, b + lo, hi - lo, job->rm);                                                 \
+    }                                                                                                                  \
+                                                                                                                       \
+    __FPFUN_LINKAGE void name(fsrc_t *dst, const fsrc_t *a, const fsrc_t *b, size_t n) {                               \
+        FBATCH_RUN(name, sizeof *dst, dst, a, b, NULL, fegetround());                                                  \
+    }
+
+FBATCH_HALF(fadd_n, __softfp_half_add)
+FBATCH_HALF(fsub_n, __softfp_half_sub)
+FBATCH_HALF(fmul_n, __softfp_half_mul)
+FBATCH_HALF(fdiv_n, __softfp_half_div)
+
+#else
+FBATCH_ARITHMETIC(fadd_n, fadd_st)
+FBATCH_ARITHMETIC(fsub_n, fsub_st)
+FBATCH_ARITHMETIC(fmul_n, fmul_st)
+FBATCH_ARITHMETIC(fdiv_n, fdiv_st)
+#endif
+
+#if FDEC == 0
+static void FBATCH_CHUNK(ffma_n)(void *arg, size_t lo, size_t hi, uint8_t *status) {
+    const softfp_batch_t *job = arg;
+    const fsrc_t *a = job->a, *b = job->b, *c = job->c;
+    fsrc_t *dst = job->dst;
+
+    for (size_t i = lo; i < hi; ++i)
+        dst[i] = ffma_st(a[i], b[i], c[i], job->rm, status);
+}
+
+__FPFUN_LINKAGE void ffma_n(fsrc_t *dst, const fsrc_t *a, const fsrc_t *b, const fsrc_t *c, size_t n) {
+    FBATCH_RUN(ffma_n, sizeof *dst, dst, a, b, c, fegetround());
+}
+
+static void FBATCH_CHUNK(fsqrt_n)(void *arg, size_t lo, size_t hi, uint8_t *status) {
+    const softfp_batch_t *job = arg;
+    const fsrc_t *a = job->a;
+    fsrc_t *dst = job->dst;
+
+    for (size_t i = lo; i < hi; ++i)
+        dst[i] = fsqrt_st(a[i], job->rm, status);
+}
+
+__FPFUN_LINKAGE void fsqrt_n(fsrc_t *dst, const fsrc_t *a, size_t n) {
+    FBATCH_RUN(fsqrt_n, sizeof *dst, dst, a, NULL, NULL, fegetround());
+}
+
+/* complex batches operate on separate arrays for the real and imaginary parts (passed to the chunks as arrays) */
+#define FBATCH_COMPLEX(name, op)                                                                                       \
+    static void FBATCH_CHUNK(name)(void *arg, size_t lo, size_t hi, uint8_t *status) {                                 \
+        const softfp_batch_t *job = arg;                                                                               \
+        fsrc_t *const *dst = job->dst;                                                                                 \
+        const fsrc_t *const *src = job->a;                                                                             \
+                                                                                                                       \
+        for (size_t i = lo; i < hi; ++i)                                                                               \
+            op(&dst[0][i], &dst[1][i], src[0][i], src[1][i], src[2][i], src[3][i], job->rm, status);                   \
+    }                                                                                                                  \
+                                                                                                                       \
+    __FPFUN_LINKAGE void name(fsrc_t *re, fsrc_t *im, const fsrc_t *ar, const fsrc_t *ai, const fsrc_t *br,            \
+                              const fsrc_t *bi, size_t n) {                                                            \
+        fsrc_t *dst[2] = {re, im};                                                                                     \
+        const fsrc_t *src[4] = {ar, ai, br, bi};                                                                       \
+                                                                                                                       \
+        FBATCH_RUN(name, sizeof *re, dst, src, NULL, NULL, fegetround());                                              \
+    }
+
+FBATCH_COMPLEX(fmulc_n, fmulc_st)
+FBATCH_COMPLEX(fdivc_n, fdivc_st)
+#endif
+
+FBATCH_FIX(ffixi32_n, ffixi32_st, int32_t)
+FBATCH_FIX(ffixi64_n, ffixi64_st, int64_t)
+FBATCH_FIX(ffixu32_n, ffixu32_st, uint32_t)
+FBATCH_FIX(ffixu64_n, ffixu64_st, uint64_t)
+
+FBATCH_FLOAT(ffloati32_n, ffloati32_st, int32_t)
+FBATCH_FLOAT(ffloati64_n, ffloati64_st, int64_t)
+FBATCH_FLOAT(ffloatu32_n, ffloatu32_st, uint32_t)
+FBATCH_FLOAT(ffloatu64_n, ffloatu64_st, uint64_t)
+
+__FPFUN_LINKAGE void fneg_n(fsrc_t *dst, const fsrc_t *a, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = fneg(a[i]);
+}
+
+static void FBATCH_CHUNK(fcmp_n)(void *arg, size_t lo, size_t hi, uint8_t *status) {
+    const softfp_batch_t *job = arg;
+    const fsrc_t *a = job->a, *b = job->b;
+    int *dst = job->dst;
+
+    for (size_t i = lo; i < hi; ++i)
+        dst[i] = fcmp_st(a[i], b[i], status);
+}
+
+__FPFUN_LINKAGE void fcmp_n(int *dst, const fsrc_t *a, const fsrc_t *b, size_t n) {
+    FBATCH_RUN(fcmp_n, MAX(sizeof *dst, sizeof *a), dst, a, b, NULL, 0);
+}
@@ -0,0 +1,328 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "../lsp.h"
+#include "../misc/arith.h"
+#include "../misc/misc.h"
+#include "common_source.h"
+
+#define faccspecial __FPFUN_STATIC(accspecial)
+#define faccinvalid __FPFUN_STATIC(accinvalid)
+#define faccadd_limbs __FPFUN_STATIC(accadd_limbs)
+#define faccsum __FPFUN_STATIC(accsum)
+#define faccsum_stack __FPFUN_STATIC(accsum_stack)
+#define faccsum_heap __FPFUN_STATIC(accsum_heap)
+
+/*
+ * exact (Kulisch) accumulator. The sum is kept as a two's complement fixed-point number, whose least significant bit
+ * has the weight 2^FACC_LSB (the square of the smallest denormal), so that every value and every product of two values
+ * can be added without rounding. The 64 bits of headroom at the top (see make_acc_type in configure.sh) allow for at
+ * least 2^63 terms before the sum could wrap around. Since the integer addition is associative, the rounded result
+ * does not depend on the order of the terms.
+ *
+ * Infinities and NaNs are tracked in _flags (the first NaN is kept in _nan), and the exceptions raised by the terms are
+ * collected in _status. They are only raised when the accumulator is rounded.
+ */
+
+#define FACC_LSB (2 * (FMINEXP(FEXP) - FFRAC))
+#define FACC_LIMBS (8 * sizeof((facc_t *) 0)->_ / LIMB_BITS)
+
+/* the window of the sum that is passed to __softfp_round (the round bit is always within the window) */
+#define FACC_WINDOW (BITS_TO_LIMBS(FFRAC + 2) + 1)
+
+/* fsum_n and fdot_n allocate larger accumulators on the heap */
+#define FACC_STACK_MAX 16384
+
+#define FACC_NAN 1
+#define FACC_POS_INF 2
+#define FACC_NEG_INF 4
+#define FACC_NOT_POS_ZERO 8  // a term other than +0 was added
+#define FACC_NOT_NEG_ZERO 16 // a term other than -0 was added
+
+_Static_assert(8 * sizeof((facc_t *) 0)->_ >= 4 * FBIAS(FEXP) + 2 * FFRAC + 64, "accumulator too small");
+
+static inline void faccspecial(facc_t *acc, uint8_t flag, const fsrc_t *nan);
+
+/* records the default NaN and raises FE_INVALID */
+static inline void faccinvalid(facc_t *acc) {
+    FDECL(z);
+    fsrc_t nan;
+
+    (void) z_C;
+
+    z_S = 1;
+    FQNAN(z);
+    FPACK(z, nan);
+
+    acc->_status |= SOFTFP_STATUS_INVALID;
+    faccspecial(acc, FACC_NAN, &nan);
+}
+
+/* records the infinity `flag` or the NaN `nan` (if `flag` is FACC_NAN) */
+static inline void faccspecial(facc_t *acc, uint8_t flag, const fsrc_t *nan) {
+    acc->_flags |= FACC_NOT_POS_ZERO | FACC_NOT_NEG_ZERO;
+
+    if (acc->_flags & FACC_NAN)
+        return;
+
+    if (flag == FACC_NAN) {
+        acc->_nan = *nan;
+        acc->_flags |= FACC_NAN;
+    } else if (acc->_flags & (flag ^ (FACC_POS_INF | FACC_NEG_INF))) // Inf - Inf
+        faccinvalid(acc);
+    else
+        acc->_flags |= flag;
+}
+
+/* records the first NaN operand (quieted) and raises FE_INVALID for signaling NaNs, see FARITHMETIC_NAN_CHECK */
+#define FACC_NAN_CHECK(acc, x, y)                                                                                      \
+    do {                                                                                                               \
+        if (x##_C == FCLS_SNAN || y##_C == FCLS_SNAN || x##_C == FCLS_ILLEGAL || y##_C == FCLS_ILLEGAL)                \
+            (acc)->_status |= SOFTFP_STATUS_INVALID;                                                                   \
+                                                                                                                       \
+        if (x##_C == FCLS_SNAN || x##_C == FCLS_QNAN) {                                                                \
+            fsrc_t __nan;                                                                                              \
+            FSET_QNAN(x, 1);                                                                                           \
+            FPACK(x, __nan);                                                                                           \
+            faccspecial((acc), FACC_NAN, &__nan);                                                                      \
+            return;                                                                                                    \
+        }                                                                                                              \
+                                                                                                                       \
+        if (y##_C == FCLS_SNAN || y##_C == FCLS_QNAN) {                                                                \
+            fsrc_t __nan;                                                                                              \
+            FSET_QNAN(y, 1);                                                                                           \
+            FPACK(y, __nan);                                                                                           \
+            faccspecial((acc), FACC_NAN, &__nan);                                                                      \
+            return;                                                                                                    \
+        }                                                                                                              \
+                                                                                                                       \
+        if (x##_C == FCLS_ILLEGAL || y##_C == FCLS_ILLEGAL) {                                                          \
+            faccinvalid((acc));                                                                                        \
+            return;                                                                                                    \
+        }                                                                                                              \
+                                                                                                                       \
+        if (x##_C == FCLS_DENORMAL || y##_C == FCLS_DENORMAL)                                                          \
+            (acc)->_status |= SOFTFP_STATUS_DENORM;                                                                    \
+    } while (0)
+
+/* adds `f * 2^exp` to the accumulator */
+static inline void faccadd_limbs(facc_t *acc, limb_t f[], size_t n, int32_t exp, bool sign) {
+    int32_t shift = exp - FACC_LSB;
+
+    // the trailing bits of normalized denormals are zero, so this is exact
+    if (shift < 0) {
+        __softfp_arr_shift(f, n, shift);
+        shift = 0;
+    }
+
+    acc->_flags |= FACC_NOT_POS_ZERO | FACC_NOT_NEG_ZERO;
+    __softfp_acc_add((limb_t *) acc->_, FACC_LIMBS, f, n, shift, sign);
+}
+
+__FPFUN_LINKAGE void faccinit(facc_t *acc) {
+    memset(acc, 0, sizeof *acc);
+}
+
+__FPFUN_LINKAGE void faccadd(facc_t *acc, fsrc_t a) {
+    FDECL(x);
+    FUNPACK(x, a);
+
+    FACC_NAN_CHECK(acc, x, x);
+
+    if (x_C == FCLS_INF)
+        faccspecial(acc, x_S ? FACC_NEG_INF : FACC_POS_INF, NULL);
+    else if (x_C == FCLS_ZERO)
+        acc->_flags |= x_S ? FACC_NOT_POS_ZERO : FACC_NOT_NEG_ZERO;
+    else
+        faccadd_limbs(acc, x_F, sizeof x_F / sizeof *x_F, x_E - FFRAC, x_S);
+}
+
+__FPFUN_LINKAGE void faccmadd(facc_t *acc, fsrc_t a, fsrc_t b) {
+    FDECL(x);
+    FDECL(y);
+
+    FUNPACK(x, a);
+    FUNPACK(y, b);
+
+    FACC_NAN_CHECK(acc, x, y);
+
+    bool sign = x_S ^ y_S;
+
+    if ((x_C == FCLS_INF && y_C == FCLS_ZERO) || (x_C == FCLS_ZERO && y_C == FCLS_INF))
+        faccinvalid(acc);
+    else if (x_C == FCLS_INF || y_C == FCLS_INF)
+        faccspecial(acc, sign ? FACC_NEG_INF : FACC_POS_INF, NULL);
+    else if (x_C == FCLS_ZERO || y_C == FCLS_ZERO)
+        acc->_flags |= sign ? FACC_NOT_POS_ZERO : FACC_NOT_NEG_ZERO;
+    else {
+        limb_t prod[2 * (sizeof x_F / sizeof *x_F)];
+        __softfp_mul(prod, x_F, y_F, sizeof x_F / sizeof *x_F);
+
+        faccadd_limbs(acc, prod, sizeof prod / sizeof *prod, x_E + y_E - 2 * FFRAC, sign);
+    }
+}
+
+__FPFUN_LINKAGE void faccmerge(facc_t *acc, const facc_t *src) {
+    acc->_status |= src->_status;
+    acc->_flags |= src->_flags & (FACC_NOT_POS_ZERO | FACC_NOT_NEG_ZERO);
+
+    if (src->_flags & FACC_NAN)
+        faccspecial(acc, FACC_NAN, &src->_nan);
+
+    if (src->_flags & FACC_POS_INF)
+        faccspecial(acc, FACC_POS_INF, NULL);
+
+    if (src->_flags & FACC_NEG_INF)
+        faccspecial(acc, FACC_NEG_INF, NULL);
+
+    __softfp_add((limb_t *) acc->_, (const limb_t *) acc->_, (const limb_t *) src->_, FACC_LIMBS);
+}
+
+__FPFUN_LINKAGE fsrc_t faccround_st(const facc_t *acc, int rm, uint8_t *status) {
+    const limb_t *sum = (const limb_t *) acc->_;
+
+    FDECL(z);
+
+    (void) z_C;
+
+    STATUS_RAISE(acc->_status);
+
+    if (acc->_flags & FACC_NAN)
+        return acc->_nan;
+
+    if (acc->_flags & (FACC_POS_INF | FACC_NEG_INF)) {
+        z_S = !!(acc->_flags & FACC_NEG_INF);
+        FINF(z);
+        FRETURN(z);
+    }
+
+    z_S = sum[FACC_LIMBS - 1] >> (LIMB_BITS - 1);
+
+    size_t low = 0; // the least significant non-zero limb
+
+    while (low < FACC_LIMBS && !sum[low])
+        ++low;
+
+    if (low == FACC_LIMBS) { // exact zero
+        if (!(acc->_flags & FACC_NOT_NEG_ZERO))
+            z_S = !!(acc->_flags & FACC_NOT_POS_ZERO); // only -0 terms (or no terms at all)
+        else
+            z_S = (acc->_flags & FACC_NOT_POS_ZERO) && rm == FE_DOWNWARD;
+
+        FZERO(z);
+        FRETURN(z);
+    }
+
+// the i-th limb of |sum| (the two's complement of a negative sum is ~sum + 1, where the carry stops at limb `low`)
+#define FACC_MAGNITUDE(i) ((i) < low ? 0 : !z_S ? sum[(i)] : (i) == low ? -sum[(i)] : ~sum[(i)])
+
+    size_t top = FACC_LIMBS - 1;
+
+    while (!FACC_MAGNITUDE(top))
+        --top;
+
+    limb_t window[FACC_WINDOW];
+    ptrdiff_t base = (ptrdiff_t) top + 1 - FACC_WINDOW;
+
+    for (ptrdiff_t i = 0; i < FACC_WINDOW; ++i)
+        window[i] = base + i < 0 ? 0 : FACC_MAGNITUDE((size_t) (base + i));
+
+#undef FACC_MAGNITUDE
+
+    // any non-zero limb below the window only affects the sticky bit
+    int round = base > 0 && low < (size_t) base ? BIT_STICKY : 0;
+
+    z_E = FACC_LSB + (int32_t) base * LIMB_BITS + FFRAC;
+
+    FROUND_AND_NORMALIZE(z, window, round, rm);
+    memcpy(z_F, window, sizeof z_F);
+
+    FRETURN(z);
+}
+
+__FPFUN_LINKAGE fsrc_t faccround_rm(const facc_t *acc, int rm) {
+    STATUS_RETURN(fsrc_t, faccround_st(acc, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t faccround(const facc_t *acc) {
+    return faccround_rm(acc, fegetround());
+}
+
+/* rounds the sum of a[i] (or a[i] * b[i] if b is not NULL) using the accumulator `acc` */
+static inline fsrc_t faccsum(facc_t *acc, const fsrc_t *a, const fsrc_t *b, size_t n) {
+    faccinit(acc);
+
+    if (b)
+        for (size_t i = 0; i < n; ++i)
+            faccmadd(acc, a[i], b[i]);
+    else
+        for (size_t i = 0; i < n; ++i)
+            faccadd(acc, a[i]);
+
+    return faccround(acc);
+}
+
+static inline fsrc_t faccsum_stack(const fsrc_t *a, const fsrc_t *b, size_t n) {
+    facc_t acc;
+    return faccsum(&acc, a, b, n);
+}
+
+/*
+ * the accumulator of the wide formats is too large for small thread stacks (e.g. 128 KiB for binary256), so it is
+ * allocated on the heap instead. If that fails, the default NaN is returned and FE_INVALID is raised.
+ */
+static inline fsrc_t faccsum_heap(const fsrc_t *a, const fsrc_t *b, size_t n) {
+    facc_t *acc = malloc(sizeof *acc);
+
+    if (!acc) {
+        FDECL(z);
+        fsrc_t nan;
+
+        (void) z_C;
+
+        z_S = 1;
+        FQNAN(z);
+        FPACK(z, nan);
+
+        __softfp_merge_status(SOFTFP_STATUS_INVALID);
+        return nan;
+    }
+
+    fsrc_t res = faccsum(acc, a, b, n);
+    free(acc);
+    return res;
+}
+
+__FPFUN_LINKAGE fsrc_t fsum_n(const fsrc_t *a, size_t n) {
+    if (sizeof(facc_t) > FACC_STACK_MAX)
+        return faccsum_heap(a, NULL, n);
+
+    return faccsum_stack(a, NULL, n);
+}
+
+__FPFUN_LINKAGE fsrc_t fdot_n(const fsrc_t *a, const fsrc_t *b, size_t n) {
+    if (sizeof(facc_t) > FACC_STACK_MAX)
+        return faccsum_heap(a, b, n);
+
+    return faccsum_stack(a, b, n);
+}
@@ -21,34 +21,55 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
 #include "../misc/arith.h"
 #include "../misc/divmnu.h"
 #include "../misc/misc.h"
 #include "common_source.h"
-#include <stdio.h>
+#include "scalar.h"
+
+#define faddsub_limbs __FPFUN_STATIC(addsub_limbs)
+#define fmul_limbs __FPFUN_STATIC(mul_limbs)
+#define fmul_finite __FPFUN_STATIC(mul_finite)
+#define fdiv_limbs __FPFUN_STATIC(div_limbs)
 
 #define NWORDS (sizeof z_F / sizeof *z_F)
 
-#define FARITHMETIC_BASIC_CHECK(x)                                                                                     \
+/* returns the first NaN operand (quieted) and raises FE_INVALID if either operand is a signaling NaN */
+#define FARITHMETIC_NAN_CHECK(x, y)                                                                                    \
     do {                                                                                                               \
-        switch (x##_C) {                                                                                               \
-            case FCLS_SNAN:                                                                                            \
-                FSET_QNAN(x, 1);                                                                                       \
-                feraiseexcept(FE_INVALID);                                                                             \
-            case FCLS_QNAN:                                                                                            \
-                FRETURN(x);                                                                                            \
-            default:                                                                                                   \
-                break;                                                                                                 \
+        if (x##_C == FCLS_SNAN || y##_C == FCLS_SNAN || x##_C == FCLS_ILLEGAL || y##_C == FCLS_ILLEGAL)                \
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);                                                                       \
+                                                                                                                       \
+        if (x##_C == FCLS_SNAN || x##_C == FCLS_QNAN) {                                                                \
+            FSET_QNAN(x, 1);                                                                                           \
+            FRETURN(x);                                                                                                \
+        }                                                                                                              \
+                                                                                                                       \
+        if (y##_C == FCLS_SNAN || y##_C == FCLS_QNAN) {                                                                \
+            FSET_QNAN(y, 1);                                                                                           \
+            FRETURN(y);                                                                                                \
         }                                                                                                              \
                                                                                                                        \
-        if (x##_C == FCLS_DENORMAL)                                                                                    \
-            feraiseexcept(FE_DENORM);                                                                                  \
+        if (x##_C == FCLS_ILLEGAL || y##_C == FCLS_ILLEGAL) {                                                          \
+            x##_S = 1;                                                                                                 \
+            FQNAN(x);                                                                                                  \
+            FRETURN(x);                                                                                                \
+        }                                                                                                              \
+                                                                                                                       \
+        if (x##_C == FCLS_DENORMAL || y##_C == FCLS_DENORMAL)                                                          \
+            STATUS_RAISE(SOFTFP_STATUS_DENORM);                                                                        \
+    } while (0)
+
+/* the result of an invalid operation is the default NaN (which has the sign bit set) */
+#define FARITHMETIC_INVALID(z)                                                                                         \
+    do {                                                                                                               \
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);                                                                           \
+        z##_S = 1;                                                                                                     \
+        FQNAN(z);                                                                                                      \
     } while (0)
 
-static inline fsrc_t faddsub(fsrc_t a, fsrc_t b, bool sub) {
+static inline fsrc_t faddsub_limbs(fsrc_t a, fsrc_t b, bool sub, int rm, uint8_t *status) {
     FDECL(x);
     FDECL(y);
     FDECL(z);
@@ -56,53 +77,97 @@ static inline fsrc_t faddsub(fsrc_t a, fsrc_t b, bool sub) {
     FUNPACK(x, a);
     FUNPACK(y, b);
 
+    FARITHMETIC_NAN_CHECK(x, y);
+
     if (sub)
         y_S = !y_S;
 
-    FARITHMETIC_BASIC_CHECK(x);
-    FARITHMETIC_BASIC_CHECK(y);
-
     if (x_C == FCLS_INF && y_C == FCLS_INF && x_S != y_S) {
-        feraiseexcept(FE_INVALID);
-        z_S = 1;
-        FQNAN(z);
+        FARITHMETIC_INVALID(z);
         goto done;
     }
 
+    if (x_C == FCLS_INF)
+        FRETURN(x);
+
+    if (y_C == FCLS_INF)
+        FRETURN(y);
+
     if (x_C == FCLS_ZERO && y_C == FCLS_ZERO) {
-        z_S = (x_S && y_S) || (fegetround() == FE_DOWNWARD);
+        z_S = x_S == y_S ? x_S : rm == FE_DOWNWARD;
         FZERO(z);
         goto done;
     }
 
-    if (x_C == FCLS_INF || y_C == FCLS_ZERO)
+    if (y_C == FCLS_ZERO)
         FRETURN(x);
 
-    if (y_C == FCLS_INF || x_C == FCLS_ZERO)
+    if (x_C == FCLS_ZERO)
         FRETURN(y);
 
+    // three additional bits below the significands (guard, round and sticky) and one bit for the carry
+
+    limb_t xw[BITS_TO_LIMBS(FFRAC + 5)] = {0};
+    limb_t yw[BITS_TO_LIMBS(FFRAC + 5)] = {0};
+    limb_t zw[BITS_TO_LIMBS(FFRAC + 5)];
+
+    memcpy(xw, x_F, sizeof x_F);
+    memcpy(yw, y_F, sizeof y_F);
+
+    ARRAY_LSHIFT(xw, 3);
+    ARRAY_LSHIFT(yw, 3);
+
+    bool x_big = x_E >= y_E;
+    limb_t *big = x_big ? xw : yw;
+    limb_t *small = x_big ? yw : xw;
+
     z_E = MAX(x_E, y_E);
 
-    int round = x_E == z_E ? ARRAY_RSHIFT(y_F, z_E - y_E) : ARRAY_RSHIFT(x_F, z_E - x_E);
+    // align the smaller operand; any bits shifted out are collapsed into the sticky bit
 
-    uint8_t carry = addsub(z_F, x_F, y_F, sizeof x_F / sizeof *x_F, x_S != y_S);
+    if (__softfp_arr_shift(small, sizeof xw / sizeof *xw, -(x_big ? x_E - y_E : y_E - x_E)) & (BIT_ROUND | BIT_STICKY))
+        small[0] |= 1;
 
-    z_S = x_S ^ carry;
+    if (x_S == y_S) {
+        __softfp_add(zw, xw, yw, sizeof zw / sizeof *zw);
+        z_S = x_S;
+    } else {
+        int borrow = __softfp_sub(zw, big, small, sizeof zw / sizeof *zw);
+        z_S = (x_big ? x_S : y_S) ^ borrow;
+
+        if (ARRAY_IS_ZERO(zw)) { // exact cancellation
+            z_S = rm == FE_DOWNWARD;
+            FZERO(z);
+            goto done;
+        }
+    }
 
-    FROUND_AND_NORMALIZE(z, round);
+    z_E -= 3;
+
+    FROUND_AND_NORMALIZE(z, zw, 0, rm);
+    memcpy(z_F, zw, sizeof z_F);
 done:
     FRETURN(z);
 }
 
-fsrc_t fadd(fsrc_t a, fsrc_t b) {
-    return faddsub(a, b, false);
-}
+/* multiplies the finite, nonzero operands `x` and `y` (as unpacked by FUNPACK) and rounds the product */
+static inline fsrc_t fmul_finite(bool sign, int32_t x_E, const limb_t x_F[], int32_t y_E, const limb_t y_F[], int rm,
+                                 uint8_t *status) {
+    FDECL(z);
+
+    (void) z_C;
 
-fsrc_t fsub(fsrc_t a, fsrc_t b) {
-    return faddsub(a, b, true);
+    z_S = sign;
+    z_E = x_E + y_E;
+
+    // only the upper half of the product is kept, the rest is folded into the rounding bits
+    int round = __softfp_mul_shr(z_F, x_F, y_F, NWORDS, FFRAC);
+
+    FROUND_AND_NORMALIZE(z, z_F, round, rm);
+    FRETURN(z);
 }
 
-fsrc_t fmul(fsrc_t a, fsrc_t b) {
+static inline fsrc_t fmul_limbs(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
     FDECL(x);
     FDECL(y);
     FDECL(z);
@@ -110,14 +175,12 @@ fsrc_t fmul(fsrc_t a, fsrc_t b) {
     FUNPACK(x, a);
     FUNPACK(y, b);
 
-    FARITHMETIC_BASIC_CHECK(x);
-    FARITHMETIC_BASIC_CHECK(y);
+    FARITHMETIC_NAN_CHECK(x, y);
 
     z_S = x_S ^ y_S;
 
     if ((x_C == FCLS_INF && y_C == FCLS_ZERO) || (x_C == FCLS_ZERO && y_C == FCLS_INF)) {
-        feraiseexcept(FE_INVALID);
-        FQNAN(z);
+        FARITHMETIC_INVALID(z);
         goto done;
     }
 
@@ -131,27 +194,12 @@ fsrc_t fmul(fsrc_t a, fsrc_t b) {
         goto done;
     }
 
-    z_E = x_E + y_E;
-
-    uint32_t prod[NWORDS * 2] = {0};
-    uint32_t mult[NWORDS * 2] = {0};
-    size_t shift = 0;
-    uint8_t carry;
-
-    memcpy(mult, x_F, sizeof x_F);
-
-    __softfp_mul(prod, mult, y_F, NWORDS);
-
-    int round = ARRAY_RSHIFT(prod, FFRAC);
-
-    memcpy(z_F, prod, sizeof z_F);
-
-    FROUND_AND_NORMALIZE(z, round);
+    return fmul_finite(z_S, x_E, x_F, y_E, y_F, rm, status);
 done:
     FRETURN(z);
 }
 
-fsrc_t fdiv(fsrc_t a, fsrc_t b) {
+static inline fsrc_t fdiv_limbs(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
     FDECL(x);
     FDECL(y);
     FDECL(z);
@@ -159,14 +207,12 @@ fsrc_t fdiv(fsrc_t a, fsrc_t b) {
     FUNPACK(x, a);
     FUNPACK(y, b);
 
-    FARITHMETIC_BASIC_CHECK(x);
-    FARITHMETIC_BASIC_CHECK(y);
+    FARITHMETIC_NAN_CHECK(x, y);
 
     z_S = x_S ^ y_S;
 
     if ((x_C == FCLS_INF && y_C == FCLS_INF) || (x_C == FCLS_ZERO && y_C == FCLS_ZERO)) {
-        feraiseexcept(FE_INVALID);
-        FQNAN(z);
+        FARITHMETIC_INVALID(z);
         goto done;
     }
 
@@ -176,7 +222,7 @@ fsrc_t fdiv(fsrc_t a, fsrc_t b) {
     }
 
     if (y_C == FCLS_ZERO) {
-        feraiseexcept(FE_DIVBYZERO);
+        STATUS_RAISE(SOFTFP_STATUS_DIVBYZERO);
         FINF(z);
         goto done;
     }
@@ -186,29 +232,258 @@ fsrc_t fdiv(fsrc_t a, fsrc_t b) {
         goto done;
     }
 
-    z_E = x_E - y_E;
+    _Static_assert(FFRAC + 3 <= 8 * sizeof z_F, "quotient does not fit into the significand");
+
+    // the quotient (between 2^(FFRAC+1) and 2^(FFRAC+3)) has at least one additional bit for rounding
+    int round = __softfp_div_shl(z_F, x_F, y_F, NWORDS, FFRAC + 2);
+
+    z_E = x_E - y_E - 2;
+
+    FROUND_AND_NORMALIZE(z, z_F, round, rm);
+done:
+    FRETURN(z);
+}
+
+/* formats which fit into a single limb use the native-integer implementations from scalar.h */
+
+__FPFUN_LINKAGE fsrc_t fadd_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+#if FSCALAR == 1
+    return fscalar_addsub(a, b, false, rm, status);
+#else
+    return faddsub_limbs(a, b, false, rm, status);
+#endif
+}
+
+__FPFUN_LINKAGE fsrc_t fsub_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+#if FSCALAR == 1
+    return fscalar_addsub(a, b, true, rm, status);
+#else
+    return faddsub_limbs(a, b, true, rm, status);
+#endif
+}
+
+__FPFUN_LINKAGE fsrc_t fmul_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+#if FSCALAR == 1
+    return fscalar_mul(a, b, rm, status);
+#else
+    return fmul_limbs(a, b, rm, status);
+#endif
+}
+
+__FPFUN_LINKAGE fsrc_t fdiv_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+#if FSCALAR == 1
+    return fscalar_div(a, b, rm, status);
+#else
+    return fdiv_limbs(a, b, rm, status);
+#endif
+}
+
+/* the exact product (2 * FFRAC + 2 bits) with three additional bits for rounding and one bit for the carry */
+#define FFMA_LIMBS MAX(BITS_TO_LIMBS(2 * FFRAC + 6), 2 * NWORDS)
 
-    uint32_t rem[NWORDS] = {0};
-    uint32_t quotient[NWORDS * 2] = {0};
-    uint32_t dividend[NWORDS * 2] = {0};
+__FPFUN_LINKAGE fsrc_t ffma_st(fsrc_t a, fsrc_t b, fsrc_t c, int rm, uint8_t *status) {
+    FDECL(x);
+    FDECL(y);
+    FDECL(w);
+    FDECL(z);
+
+    (void) z_C;
+
+    FUNPACK(x, a);
+    FUNPACK(y, b);
+    FUNPACK(w, c);
+
+    // 0 * Inf is invalid, even if the addend is a quiet NaN
+    bool invalid = (x_C == FCLS_INF && y_C == FCLS_ZERO) || (x_C == FCLS_ZERO && y_C == FCLS_INF);
+
+    if (invalid || w_C == FCLS_SNAN || w_C == FCLS_ILLEGAL)
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);
 
-    memcpy(&dividend[NWORDS], x_F, sizeof x_F);
+    FARITHMETIC_NAN_CHECK(x, y);
 
-    divmnu(quotient, rem, dividend, y_F, NWORDS * 4, BITS_TO_WORDS(2 * ARRAY_MSB(y_F)));
+    if (w_C == FCLS_SNAN || w_C == FCLS_QNAN) {
+        FSET_QNAN(w, 1);
+        FRETURN(w);
+    }
 
-    int round = ARRAY_RSHIFT(quotient, NWORDS * 32 - FFRAC);
+    if (invalid || w_C == FCLS_ILLEGAL) {
+        FARITHMETIC_INVALID(z);
+        goto done;
+    }
 
-    if (!ARRAY_IS_ZERO(rem))
-        round |= BIT_STICKY;
+    if (w_C == FCLS_DENORMAL)
+        STATUS_RAISE(SOFTFP_STATUS_DENORM);
+
+    z_S = x_S ^ y_S;
 
-    memcpy(z_F, quotient, sizeof z_F);
+    if (x_C == FCLS_INF || y_C == FCLS_INF) {
+        if (w_C == FCLS_INF && w_S != z_S)
+            FARITHMETIC_INVALID(z);
+        else
+            FINF(z);
+
+        goto done;
+    }
 
-    FROUND_AND_NORMALIZE(z, round);
+    if (w_C == FCLS_INF)
+        FRETURN(w);
+
+    if (x_C == FCLS_ZERO || y_C == FCLS_ZERO) {
+        if (w_C != FCLS_ZERO)
+            FRETURN(w);
+
+        z_S = z_S == w_S ? z_S : rm == FE_DOWNWARD;
+        FZERO(z);
+        goto done;
+    }
+
+    // both values are scaled by 2^(-2 * FFRAC), i.e. the significand of the addend is extended to the product's width
+
+    limb_t pw[FFMA_LIMBS] = {0};
+    limb_t ww[FFMA_LIMBS] = {0};
+    limb_t zw[FFMA_LIMBS];
+
+    __softfp_mul(pw, x_F, y_F, NWORDS);
+
+    int32_t p_E = x_E + y_E;
+
+    if (w_C == FCLS_ZERO) {
+        z_E = p_E - FFRAC;
+
+        FROUND_AND_NORMALIZE(z, pw, 0, rm);
+        memcpy(z_F, pw, sizeof z_F);
+        goto done;
+    }
+
+    memcpy(ww, w_F, sizeof w_F);
+
+    ARRAY_LSHIFT(pw, 3);
+    ARRAY_LSHIFT(ww, FFRAC + 3);
+
+    // as in addition, the three additional bits ensure that aligning the smaller operand only loses the sticky bit
+
+    bool p_big = p_E >= w_E;
+    limb_t *big = p_big ? pw : ww;
+    limb_t *small = p_big ? ww : pw;
+
+    z_E = MAX(p_E, w_E);
+
+    if (__softfp_arr_shift(small, FFMA_LIMBS, -(p_big ? p_E - w_E : w_E - p_E)) & (BIT_ROUND | BIT_STICKY))
+        small[0] |= 1;
+
+    if (z_S == w_S)
+        __softfp_add(zw, pw, ww, FFMA_LIMBS);
+    else {
+        int borrow = __softfp_sub(zw, big, small, FFMA_LIMBS);
+        z_S = (p_big ? z_S : w_S) ^ borrow;
+
+        if (ARRAY_IS_ZERO(zw)) { // exact cancellation
+            z_S = rm == FE_DOWNWARD;
+            FZERO(z);
+            goto done;
+        }
+    }
+
+    z_E -= FFRAC + 3;
+
+    FROUND_AND_NORMALIZE(z, zw, 0, rm);
+    memcpy(z_F, zw, sizeof z_F);
 done:
     FRETURN(z);
 }
 
-fsrc_t fneg(fsrc_t a) {
+__FPFUN_LINKAGE fsrc_t fsqrt_st(fsrc_t a, int rm, uint8_t *status) {
+    FDECL(x);
+    FDECL(z);
+
+    (void) z_C;
+
+    FUNPACK(x, a);
+
+    if (x_C == FCLS_SNAN || x_C == FCLS_QNAN) {
+        if (x_C == FCLS_SNAN)
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);
+
+        FSET_QNAN(x, 1);
+        FRETURN(x);
+    }
+
+    // sqrt(-0) = -0, but the root of any other negative number is invalid
+    if (x_C == FCLS_ILLEGAL || (x_S && x_C != FCLS_ZERO)) {
+        FARITHMETIC_INVALID(z);
+        FRETURN(z);
+    }
+
+    if (x_C == FCLS_ZERO || x_C == FCLS_INF)
+        FRETURN(x);
+
+    if (x_C == FCLS_DENORMAL)
+        STATUS_RAISE(SOFTFP_STATUS_DENORM);
+
+    _Static_assert(2 * FFRAC + 5 <= 16 * sizeof z_F, "radicand does not fit into twice the significand");
+    _Static_assert(FFRAC + 3 <= 8 * sizeof z_F, "root does not fit into the significand");
+
+    // the radicand is shifted, so that its exponent is even and the root has at least one additional bit for rounding
+
+    int32_t shift = FFRAC + 3 + ((x_E + 1) & 1);
+    int round = __softfp_sqrt_shl(z_F, x_F, NWORDS, shift);
+
+    z_S = 0;
+    z_E = FFRAC + (x_E - FFRAC - shift) / 2;
+
+    FROUND_AND_NORMALIZE(z, z_F, round, rm);
+    FRETURN(z);
+}
+
+__FPFUN_LINKAGE fsrc_t fadd_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fadd_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fsub_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fsub_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fmul_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fmul_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fdiv_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fdiv_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffma_rm(fsrc_t a, fsrc_t b, fsrc_t c, int rm) {
+    STATUS_RETURN(fsrc_t, ffma_st(a, b, c, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fsqrt_rm(fsrc_t a, int rm) {
+    STATUS_RETURN(fsrc_t, fsqrt_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fadd(fsrc_t a, fsrc_t b) {
+    return fadd_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fsub(fsrc_t a, fsrc_t b) {
+    return fsub_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fmul(fsrc_t a, fsrc_t b) {
+    return fmul_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fdiv(fsrc_t a, fsrc_t b) {
+    return fdiv_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffma(fsrc_t a, fsrc_t b, fsrc_t c) {
+    return ffma_rm(a, b, c, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fsqrt(fsrc_t a) {
+    return fsqrt_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fneg(fsrc_t a) {
     FDECL(x);
     FUNPACK(x, a);
 
@@ -36,6 +36,9 @@
 #define __X_FBUILDTYPE_COMPLEX(B) scbinary##B##_t
 #define __FBUILDTYPE_COMPLEX(B) __X_FBUILDTYPE_COMPLEX(B)
 
+#define __X_FBUILDTYPE_ACC(B) saccbinary##B##_t
+#define __FBUILDTYPE_ACC(B) __X_FBUILDTYPE_ACC(B)
+
 typedef enum {
     FCLS_ZERO,     // E=0 J=0 F=0
     FCLS_DENORMAL, // E=0 J=0 F!=0
@@ -53,14 +56,14 @@ typedef enum {
 #define FDENORMMINEXP(E, F) (FMINEXP(E) - (F))
 #define FBIAS(E) FMAXEXP((E))
 
-#define FCOMMON_GET_NTH(x, n) (x##_F[BITS_TO_WORDS((n)) - 1] & (1 << ((n) % 32)))
-#define FCOMMON_SET_NTH(x, n, v) __set_nth_bit(&x##_F[BITS_TO_WORDS((n)) - 1], (n) % 32, (v) &1)
+#define FCOMMON_GET_NTH(x, n) (x##_F[(n) / LIMB_BITS] & ((limb_t) 1 << ((n) % LIMB_BITS)))
+#define FCOMMON_SET_NTH(x, n, v) __set_nth_bit(&x##_F[(n) / LIMB_BITS], (n) % LIMB_BITS, (v) &1)
 
-static inline void __set_nth_bit(uint32_t *arr, uint32_t bit, bool val) {
+static inline void __set_nth_bit(limb_t *arr, uint32_t bit, bool val) {
     if (val)
-        *arr |= 1 << bit;
+        *arr |= (limb_t) 1 << bit;
     else
-        *arr &= ~(1 << bit);
+        *arr &= ~((limb_t) 1 << bit);
 }
 
 #define FCOMMON_GET_JBIT(x, F) FCOMMON_GET_NTH(x, (F))
@@ -72,7 +75,7 @@ static inline void __set_nth_bit(uint32_t *arr, uint32_t bit, bool val) {
 /*
  * x_S = sign bit
  * x_E = exponent field
- * x_F = significand/mantissa/fraction (at least FRAC+JBIT+1 bits are allocated)
+ * x_F = significand/mantissa/fraction (FRAC+2 bits are allocated: the fraction, the J-bit and one carry bit)
  * x_C = classification
  */
 #define FCOMMON_DECL(x, E, J, F)                                                                                       \
@@ -81,76 +84,154 @@ static inline void __set_nth_bit(uint32_t *arr, uint32_t bit, bool val) {
     _Static_assert((E) + (J) + (F) + 1 <= 8 * sizeof(fsrc_t), "bit count type mismatch");                              \
     bool x##_S;                                                                                                        \
     int32_t x##_E;                                                                                                     \
-    uint32_t x##_F[BITS_TO_WORDS((F) + (J)) + ((((F) + (J)) % 32) != 0)];                                              \
+    limb_t x##_F[BITS_TO_LIMBS((F) + 2)];                                                                              \
     fclass_t x##_C;
 
 /* TODO not verified on big-endian systems */
 
-#define FCOMMON_UNPACK(x, f, B, E, J, F)                                                                               \
+/*
+ * The unpacking and packing macros are specialized for each format: The value is loaded into native words (a single
+ * uint16_t/uint32_t/uint64_t for formats of up to 64 bits, two or four uint64_t otherwise), so that sign, exponent and
+ * fraction can be extracted with a few shifts and masks. `F` is the number of fraction bits (excluding the J-bit).
+ */
+#define FCOMMON_UNPACK(x, f, B, E, J, F) __FCOMMON_X_UNPACK(B, x, f, (E), (J), (F))
+#define FCOMMON_PACK(x, f, B, E, J, F) __FCOMMON_X_PACK(B, x, f, (E), (J), (F))
+
+#define __FCOMMON_X_UNPACK(B, ...) __FCOMMON_UNPACK_##B(__VA_ARGS__)
+#define __FCOMMON_X_PACK(B, ...) __FCOMMON_PACK_##B(__VA_ARGS__)
+
+#define __FCOMMON_UNPACK_16(x, f, E, J, F) __FCOMMON_UNPACK_SCALAR(x, f, uint16_t, 16, E, J, F)
+#define __FCOMMON_UNPACK_32(x, f, E, J, F) __FCOMMON_UNPACK_SCALAR(x, f, uint32_t, 32, E, J, F)
+#define __FCOMMON_UNPACK_64(x, f, E, J, F) __FCOMMON_UNPACK_SCALAR(x, f, uint64_t, 64, E, J, F)
+#define __FCOMMON_UNPACK_80(x, f, E, J, F) __FCOMMON_UNPACK_WIDE(x, f, 80, E, J, F)
+#define __FCOMMON_UNPACK_128(x, f, E, J, F) __FCOMMON_UNPACK_WIDE(x, f, 128, E, J, F)
+#define __FCOMMON_UNPACK_256(x, f, E, J, F) __FCOMMON_UNPACK_WIDE(x, f, 256, E, J, F)
+
+#define __FCOMMON_PACK_16(x, f, E, J, F) __FCOMMON_PACK_SCALAR(x, f, uint16_t, 16, E, J, F)
+#define __FCOMMON_PACK_32(x, f, E, J, F) __FCOMMON_PACK_SCALAR(x, f, uint32_t, 32, E, J, F)
+#define __FCOMMON_PACK_64(x, f, E, J, F) __FCOMMON_PACK_SCALAR(x, f, uint64_t, 64, E, J, F)
+#define __FCOMMON_PACK_80(x, f, E, J, F) __FCOMMON_PACK_WIDE(x, f, 80, E, J, F)
+#define __FCOMMON_PACK_128(x, f, E, J, F) __FCOMMON_PACK_WIDE(x, f, 128, E, J, F)
+#define __FCOMMON_PACK_256(x, f, E, J, F) __FCOMMON_PACK_WIDE(x, f, 256, E, J, F)
+
+#define __FCOMMON_UNPACK_SCALAR(x, f, W, B, E, J, F)                                                                   \
+    do {                                                                                                               \
+        _Static_assert((J) == 0, "explicit J-bit requires a wide format");                                             \
+        W __w;                                                                                                         \
+        memcpy(&__w, &(f), sizeof __w);                                                                                \
+                                                                                                                       \
+        x##_S = __w >> ((B) - 1);                                                                                      \
+        x##_E = (__w >> (F)) & FSPECIALEXP((E));                                                                       \
+                                                                                                                       \
+        __w &= ((W) 1 << (F)) - 1;                                                                                     \
+                                                                                                                       \
+        memset(x##_F, 0, sizeof x##_F);                                                                                \
+        memcpy(x##_F, &__w, sizeof __w);                                                                               \
+                                                                                                                       \
+        FCOMMON_CLASSIFY_FRAC(x, (E), (J), (F), __w == 0);                                                             \
+    } while (0)
+
+#define __FCOMMON_UNPACK_WIDE(x, f, B, E, J, F)                                                                        \
     do {                                                                                                               \
-        const uint8_t *const arr = (uint8_t *) &(f);                                                                   \
-        const size_t BYTES = BITS_TO_BYTES((B));                                                                       \
-        const size_t E_BYTES = BITS_TO_BYTES((E) + 1);                                                                 \
-        const size_t F_UNUSED = (F) % 32;                                                                              \
+        _Static_assert(((F) + (J)) % 64 + (E) < 64, "exponent must not span multiple words");                          \
+        uint64_t __w[CEILDIV((B), 64)] = {0};                                                                          \
+        memcpy(__w, &(f), BITS_TO_BYTES((B)));                                                                         \
                                                                                                                        \
-        x##_S = (arr[BYTES - 1] & 0x80) == 0x80;                                                                       \
+        x##_S = __w[((B) - 1) / 64] >> (((B) - 1) % 64);                                                               \
+        x##_E = (__w[((F) + (J)) / 64] >> (((F) + (J)) % 64)) & FSPECIALEXP((E));                                      \
                                                                                                                        \
-        memcpy(&x##_E, &arr[BYTES - E_BYTES], E_BYTES);                                                                \
+        uint64_t __frac_or = 0;                                                                                        \
                                                                                                                        \
-        x##_E >>= (F) % 8;                                                                                             \
-        x##_E &= ~(UINT32_MAX << (E));                                                                                 \
+        for (size_t __i = 0; 64 * (__i + 1) <= (F); ++__i) /* the words entirely below bit F */                        \
+            __frac_or |= __w[__i];                                                                                     \
                                                                                                                        \
-        memcpy(x##_F, arr, BITS_TO_BYTES((F)));                                                                        \
+        __frac_or |= __w[(F) / 64] & (((uint64_t) 1 << ((F) % 64)) - 1);                                               \
                                                                                                                        \
-        if (F_UNUSED)                                                                                                  \
-            x##_F[BITS_TO_WORDS((F)) - 1] &= ~(UINT32_MAX << F_UNUSED);                                                \
+        __w[((F) + (J)) / 64] &= ((uint64_t) 1 << (((F) + (J)) % 64)) - 1;                                            \
                                                                                                                        \
-        FCOMMON_CLASSIFY(x, (E), (J), (F));                                                                            \
+        memset(x##_F, 0, sizeof x##_F);                                                                                \
+        memcpy(x##_F, __w, MIN(sizeof x##_F, BITS_TO_BYTES((F) + (J))));                                               \
+                                                                                                                       \
+        FCOMMON_CLASSIFY_FRAC(x, (E), (J), (F), __frac_or == 0);                                                       \
     } while (0)
 
-#define FCOMMON_PACK(x, f, B, E, J, F)                                                                                 \
+/*
+ * x_E is converted to the biased exponent. Denormal values (which have been normalized by FCOMMON_UNPACK or have
+ * x_E = FMINEXP with a cleared J-bit after rounding) are stored with a biased exponent of zero. Formats with an explicit
+ * J-bit get it set for infinities and NaNs (otherwise, e.g., binary80 would produce pseudo-infinities).
+ */
+
+#define __FCOMMON_PACK_SCALAR(x, f, W, B, E, J, F)                                                                     \
     do {                                                                                                               \
-        uint8_t *const arr = (uint8_t *) &(f);                                                                         \
-        const size_t F_BYTES = BITS_TO_BYTES((F));                                                                     \
-        const size_t E_BYTES = BITS_TO_BYTES((E));                                                                     \
+        W __w;                                                                                                         \
+        int32_t __e = x##_E + FBIAS((E));                                                                              \
+        memcpy(&__w, x##_F, sizeof __w);                                                                               \
+                                                                                                                       \
+        if (__e <= 0) {                                                                                                \
+            __w = 1 - __e < (B) ? __w >> (1 - __e) : 0;                                                                \
+            __e = 1;                                                                                                   \
+        }                                                                                                              \
+                                                                                                                       \
+        if (__e == 1 && !((__w >> (F)) & 1))                                                                           \
+            __e = 0;                                                                                                   \
                                                                                                                        \
-        x##_E = (x##_E + FBIAS((E))) & ((1 << (E)) - 1);                                                               \
+        __w &= ((W) 1 << (F)) - 1;                                                                                     \
+        __w |= (W) (__e & FSPECIALEXP((E))) << (F);                                                                    \
+        __w |= (W) x##_S << ((B) - 1);                                                                                 \
                                                                                                                        \
-        if (!(J))                                                                                                      \
-            FCOMMON_SET_JBIT(x, (F), 0);                                                                               \
+        memcpy(&(f), &__w, sizeof __w);                                                                                \
+    } while (0)
+
+#define __FCOMMON_PACK_WIDE(x, f, B, E, J, F)                                                                          \
+    do {                                                                                                               \
+        uint64_t __w[CEILDIV((B), 64)] = {0};                                                                          \
+        int32_t __e = x##_E + FBIAS((E));                                                                              \
                                                                                                                        \
-        if ((F) % 32) {                                                                                                \
-            x##_F[BITS_TO_WORDS((F)) - 1] |= x##_E << ((F) % 32);                                                      \
-            x##_E >>= (F) % 32;                                                                                        \
-            if (E_BYTES - 1)                                                                                           \
-                memcpy(&arr[F_BYTES], &x##_E, E_BYTES - 1);                                                            \
+        if (__e <= 0) {                                                                                                \
+            limb_t __f[sizeof x##_F / sizeof *x##_F];                                                                  \
+            memcpy(__f, x##_F, sizeof __f);                                                                            \
+            ARRAY_RSHIFT(__f, 1 - __e);                                                                                \
+            memcpy(__w, __f, MIN(sizeof __w, sizeof __f));                                                             \
+            __e = 1;                                                                                                   \
         } else                                                                                                         \
-            memcpy(arr, x##_F + F_BYTES, E_BYTES);                                                                     \
+            memcpy(__w, x##_F, MIN(sizeof __w, sizeof x##_F));                                                         \
+                                                                                                                       \
+        if (__e == 1 && !((__w[(F) / 64] >> ((F) % 64)) & 1))                                                          \
+            __e = 0;                                                                                                   \
                                                                                                                        \
-        memcpy(arr, x##_F, MIN(sizeof x##_F, sizeof(f)));                                                              \
+        if ((J) && __e == FSPECIALEXP((E))) /* infinities and NaNs have the J-bit set */                               \
+            __w[(F) / 64] |= (uint64_t) 1 << ((F) % 64);                                                               \
                                                                                                                        \
-        if (x##_S)                                                                                                     \
-            arr[BITS_TO_BYTES((B)) - 1] |= 0x80;                                                                       \
-        else                                                                                                           \
-            arr[BITS_TO_BYTES((B)) - 1] &= 0x7F;                                                                       \
+        __w[((F) + (J)) / 64] &= ((uint64_t) 1 << (((F) + (J)) % 64)) - 1;                                            \
+        __w[((F) + (J)) / 64] |= (uint64_t) (__e & FSPECIALEXP((E))) << (((F) + (J)) % 64);                            \
+        __w[((B) - 1) / 64] |= (uint64_t) x##_S << (((B) - 1) % 64);                                                   \
+                                                                                                                       \
+        memcpy(&(f), __w, BITS_TO_BYTES((B)));                                                                         \
     } while (0)
 
 #define FCOMMON_RETURN(x, B, E, J, F)                                                                                  \
     do {                                                                                                               \
         fsrc_t r;                                                                                                      \
-        FCOMMON_PACK(x, r, (B), (E), (J), (F));                                                                        \
+        FCOMMON_PACK(x, r, B, (E), (J), (F));                                                                          \
         return r;                                                                                                      \
     } while (0)
 
 #define FCOMMON_CLASSIFY(x, E, J, F)                                                                                   \
     do {                                                                                                               \
-        bool __frac_zero = ARRAY_IS_ZERO(x##_F);                                                                       \
+        bool __frac_zero = ARRAY_IS_ZERO(x##_F) || ((J) && ARRAY_MSB(x##_F) == (F) && ARRAY_LSB(x##_F) == (F));       \
+        FCOMMON_CLASSIFY_FRAC(x, (E), (J), (F), __frac_zero);                                                          \
+    } while (0)
+
+/* classifies `x`, where `frac_zero` is true if all fraction bits (excluding the J-bit) are zero */
+#define FCOMMON_CLASSIFY_FRAC(x, E, J, F, frac_zero)                                                                   \
+    do {                                                                                                               \
         if (!x##_E) {                                                                                                  \
-            if (__frac_zero)                                                                                           \
-                x##_C = FCLS_ZERO;                                                                                     \
-            else if ((J) && FCOMMON_GET_JBIT(x, (F))) {                                                                \
+            if ((J) && FCOMMON_GET_JBIT(x, (F))) {                                                                     \
                 x##_C = FCLS_PSEUDO;                                                                                   \
                 x##_E = 1 - FBIAS((E));                                                                                \
+            } else if ((frac_zero)) {                                                                                  \
+                x##_C = FCLS_ZERO;                                                                                     \
+                x##_E = -FBIAS((E));                                                                                   \
             } else {                                                                                                   \
                 int32_t __frac_shift = (F) -ARRAY_MSB(x##_F);                                                          \
                 x##_C = FCLS_DENORMAL;                                                                                 \
@@ -161,7 +242,7 @@ static inline void __set_nth_bit(uint32_t *arr, uint32_t bit, bool val) {
             x##_C = FCLS_ILLEGAL;                                                                                      \
         else if (x##_E == FSPECIALEXP((E))) {                                                                          \
             x##_E -= FBIAS((E));                                                                                       \
-            if (__frac_zero)                                                                                           \
+            if ((frac_zero))                                                                                           \
                 x##_C = FCLS_INF;                                                                                      \
             else if (FCOMMON_GET_QNAN(x, (F)))                                                                         \
                 x##_C = FCLS_QNAN;                                                                                     \
@@ -184,8 +265,8 @@ static inline void __set_nth_bit(uint32_t *arr, uint32_t bit, bool val) {
 #define FCOMMON_QNAN(x, E, F)                                                                                          \
     do {                                                                                                               \
         FCOMMON_INF(x, (E));                                                                                           \
-        FCOMMON_SET_QNAN(z, (F), 1);                                                                                   \
-        FCOMMON_SET_JBIT(z, (F), 1);                                                                                   \
+        FCOMMON_SET_QNAN(x, (F), 1);                                                                                   \
+        FCOMMON_SET_JBIT(x, (F), 1);                                                                                   \
     } while (0)
 
 #define FCOMMON_ZERO(x, E)                                                                                             \
@@ -194,44 +275,13 @@ static inline void __set_nth_bit(uint32_t *arr, uint32_t bit, bool val) {
         x##_E = -FBIAS((E));                                                                                           \
     } while (0)
 
-#define FCOMMON_ROUND_AND_NORMALIZE(x, round_ctrl, E, F)                                                               \
+/*
+ * rounds the significand `f` (which may be wider than x_F) according to the rounding mode `rm` and normalizes it, so
+ * that the J-bit is at bit `F`. `f` is interpreted as `f * 2^(x_E - F)`, `round_ctrl` holds the rounding bits of any
+ * bits already shifted out. The raised exceptions are ORed into the status word `status`.
+ */
+#define FCOMMON_ROUND_AND_NORMALIZE(x, f, round_ctrl, rm, E, F)                                                        \
     do {                                                                                                               \
-        int __round = (round_ctrl);                                                                                    \
-        bool __should_round = SHOULD_ROUND(x##_S, __round);                                                            \
-                                                                                                                       \
-        do {                                                                                                           \
-            bool __should_normalize = false;                                                                           \
-            int32_t __msb;                                                                                             \
-                                                                                                                       \
-            if (__should_round && ARRAY_INCREMENT(x##_F)) {                                                            \
-                __should_normalize = true;                                                                             \
-                __msb = BITS_TO_WORDS((F));                                                                            \
-                feraiseexcept(FE_INEXACT);                                                                             \
-            } else {                                                                                                   \
-                __msb = ARRAY_MSB(x##_F);                                                                              \
-                __should_normalize = __msb != (F);                                                                     \
-            }                                                                                                          \
-                                                                                                                       \
-            int32_t __shift = __msb - (F);                                                                             \
-            x##_E += __shift;                                                                                          \
-                                                                                                                       \
-            if (x##_E > FMAXEXP((E))) { /* overflow to inf */                                                          \
-                FCOMMON_INF(x, (E));                                                                                   \
-                feraiseexcept(FE_OVERFLOW);                                                                            \
-                break;                                                                                                 \
-            }                                                                                                          \
-                                                                                                                       \
-            if (x##_E < FDENORMMINEXP((E), (F))) { /* underflow to 0 */                                                \
-                FZERO(x);                                                                                              \
-                feraiseexcept(FE_UNDERFLOW);                                                                           \
-                break;                                                                                                 \
-            }                                                                                                          \
-                                                                                                                       \
-            if (x##_E < FMINEXP((E))) { /* denormal result */                                                          \
-                __shift += FMINEXP((E)) - x##_E;                                                                       \
-                x##_E = FMINEXP((E));                                                                                  \
-            }                                                                                                          \
-                                                                                                                       \
-            __round = ARRAY_RSHIFT(x##_F, __shift);                                                                    \
-        } while ((__should_round = SHOULD_ROUND(x##_S, __round)));                                                     \
-    } while (0);
+        STATUS_RAISE(__softfp_round((f), sizeof(f) / sizeof *(f), &x##_E, x##_S, (round_ctrl), (rm), (F),             \
+                                    FMINEXP((E)), FMAXEXP((E))));                                                      \
+    } while (0)
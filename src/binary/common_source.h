@@ -21,11 +21,14 @@
  * SOFTWARE.
  */
 
-#pragma once
+/* included once per source format (fsrc_t is undefined by source_reset.h) */
+#ifndef fsrc_t
+
 #include "common.h"
 
 #define fsrc_t __FBUILDTYPE(FBITS)
 #define fcomplex_t __FBUILDTYPE_COMPLEX(FBITS)
+#define facc_t __FBUILDTYPE_ACC(FBITS)
 
 #define FSIG (FFRAC + FJBIT)
 
@@ -36,9 +39,9 @@
 #define FGET_JBIT(x) FCOMMON_GET_JBIT(x, FFRAC)
 
 #define FDECL(x) FCOMMON_DECL(x, FEXP, FJBIT, FFRAC)
-#define FUNPACK(x, f) FCOMMON_UNPACK(x, f, FBITS, FEXP, FJBIT, FSIG)
-#define FPACK(x, f) FCOMMON_PACK(x, f, FBITS, FEXP, FJBIT, FSIG)
-#define FRETURN(x) FCOMMON_RETURN(x, FBITS, FEXP, FJBIT, FSIG)
+#define FUNPACK(x, f) FCOMMON_UNPACK(x, f, FBITS, FEXP, FJBIT, FFRAC)
+#define FPACK(x, f) FCOMMON_PACK(x, f, FBITS, FEXP, FJBIT, FFRAC)
+#define FRETURN(x) FCOMMON_RETURN(x, FBITS, FEXP, FJBIT, FFRAC)
 
 #define FCLASSIFY(x) FCOMMON_CLASSIFY(x, FEXP, FJBIT, FFRAC)
 
@@ -46,11 +49,18 @@
 #define FINF(x) FCOMMON_INF(x, FEXP)
 #define FZERO(x) FCOMMON_ZERO(x, FEXP)
 
-#define FROUND_AND_NORMALIZE(x, round) FCOMMON_ROUND_AND_NORMALIZE(x, round, FEXP, FFRAC)
+#define FROUND_AND_NORMALIZE(x, f, round, rm) FCOMMON_ROUND_AND_NORMALIZE(x, f, round, rm, FEXP, FFRAC)
 
 #if FCAST_ONLY == 0
 #include "arithmetic.h"
 #include "compare.h"
 #include "complex.h"
+#include "accumulator.h"
 #include "intconv.h"
+#include "sortkey.h"
+
+#include "../batch.h"
+#include "../sort.h"
+#endif
+
 #endif
@@ -21,14 +21,16 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
 #include "common_source.h"
 
 #define CMP_NAN 2
 
-static inline int cmpimpl(fsrc_t a, fsrc_t b) {
+#define cmpimpl __FPFUN_STATIC(cmpimpl)
+#define cmpnan __FPFUN_STATIC(cmpnan)
+#define fcmp_st __FPFUN_STATIC(cmp_st)
+
+static inline int cmpimpl(fsrc_t a, fsrc_t b, uint8_t *status) {
     FDECL(x);
     FDECL(y);
 
@@ -36,7 +38,7 @@ static inline int cmpimpl(fsrc_t a, fsrc_t b) {
     FUNPACK(y, b);
 
     if (x_C == FCLS_SNAN || y_C == FCLS_SNAN) {
-        feraiseexcept(FE_INVALID);
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);
         return CMP_NAN;
     }
 
@@ -88,16 +90,20 @@ static inline int cmpimpl(fsrc_t a, fsrc_t b) {
     }
 }
 
-int fcmp(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
+/* replaces the unordered result of cmpimpl with `nan` */
+static inline int cmpnan(int cmp, int nan) {
+    return cmp == CMP_NAN ? nan : cmp;
+}
 
-    if (cmp == CMP_NAN)
-        return 1;
+static inline int fcmp_st(fsrc_t a, fsrc_t b, uint8_t *status) {
+    return cmpnan(cmpimpl(a, b, status), 1);
+}
 
-    return cmp;
+__FPFUN_LINKAGE int fcmp(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, fcmp_st(a, b, status));
 }
 
-int funord(fsrc_t a, fsrc_t b) {
+__FPFUN_LINKAGE int funord(fsrc_t a, fsrc_t b) {
     FDECL(x);
     FDECL(y);
 
@@ -112,32 +118,26 @@ int funord(fsrc_t a, fsrc_t b) {
     return x_C == FCLS_QNAN || y_C == FCLS_QNAN;
 }
 
-int feq(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
-    return cmp == CMP_NAN ? 1 : cmp;
+__FPFUN_LINKAGE int feq(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fne(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
-    return cmp == CMP_NAN ? 1 : cmp;
+__FPFUN_LINKAGE int fne(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fge(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
-    return cmp == CMP_NAN ? -1 : cmp;
+__FPFUN_LINKAGE int fge(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), -1));
 }
 
-int flt(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
-    return cmp == CMP_NAN ? 1 : cmp;
+__FPFUN_LINKAGE int flt(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fle(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
-    return cmp == CMP_NAN ? 1 : cmp;
+__FPFUN_LINKAGE int fle(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fgt(fsrc_t a, fsrc_t b) {
-    int cmp = cmpimpl(a, b);
-    return cmp == CMP_NAN ? -1 : cmp;
+__FPFUN_LINKAGE int fgt(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), -1));
 }
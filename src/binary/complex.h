@@ -21,11 +21,13 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
 #include "common_source.h"
 
+#undef Re
+#undef Im
+#undef Complex
+
 #if FSTDCOMPLEX == 1
 #include <complex.h>
 
@@ -41,7 +43,9 @@
 #define Complex(x, y) ((fcomplex_t){(x), (y)})
 #endif
 
-static inline fsrc_t __copysign(fsrc_t a, fsrc_t b) {
+#define fcopysign __FPFUN_STATIC(copysign)
+
+static inline fsrc_t fcopysign(fsrc_t a, fsrc_t b) {
     FDECL(x);
     FDECL(y);
     FUNPACK(x, a);
@@ -52,13 +56,121 @@ static inline fsrc_t __copysign(fsrc_t a, fsrc_t b) {
     FRETURN(x);
 }
 
-fcomplex_t fmulc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
-    fsrc_t ac = fmul(a, c);
-    fsrc_t bd = fmul(b, d);
-    fsrc_t ad = fmul(a, d);
-    fsrc_t bc = fmul(b, c);
-    fsrc_t x = fsub(ac, bd);
-    fsrc_t y = fadd(ad, bc);
+/*
+ * the operands of the products are unpacked only once. FCDECL and FCUNPACK declare and unpack an operand, FCMUL
+ * multiplies two finite operands (which need not be checked for NaNs and infinities anymore).
+ */
+#if FSCALAR == 1
+#define FCDECL(x)                                                                                                      \
+    limb_t x##_s, x##_m, x##_f;                                                                                        \
+    int32_t x##_e
+#define FCUNPACK(x, v)                                                                                                 \
+    do {                                                                                                               \
+        x##_s = fscalar_bits(v) & FSCALAR_SIGN;                                                                        \
+        x##_m = fscalar_bits(v) & ~FSCALAR_SIGN;                                                                       \
+        x##_e = 0;                                                                                                     \
+        x##_f = x##_m && x##_m < FSCALAR_INF ? fscalar_unpack(x##_m, &x##_e) : 0;                                      \
+    } while (0)
+#define FCFINITE(x) (x##_m < FSCALAR_INF)
+#define FCDENORMAL(x) (x##_m && x##_m <= FSCALAR_FRAC)
+#define FCMUL(x, y, st)                                                                                                \
+    (!x##_m || !y##_m ? fscalar_value(x##_s ^ y##_s)                                                                   \
+                      : fscalar_mul_finite(x##_s ^ y##_s, x##_e, x##_f, y##_e, y##_f, rm, (st)))
+#else
+#define FCDECL(x) FDECL(x)
+#define FCUNPACK(x, v) FUNPACK(x, v)
+#define FCFINITE(x) (x##_C == FCLS_ZERO || x##_C == FCLS_NORMAL || x##_C == FCLS_DENORMAL)
+#define FCDENORMAL(x) (x##_C == FCLS_DENORMAL)
+#define FCMUL(x, y, st)                                                                                                \
+    (x##_C == FCLS_ZERO || y##_C == FCLS_ZERO ? fczero(x##_S ^ y##_S)                                                  \
+                                              : fmul_finite(x##_S ^ y##_S, x##_E, x##_F, y##_E, y##_F, rm, (st)))
+
+#define fczero __FPFUN_STATIC(czero)
+
+static inline fsrc_t fczero(bool sign) {
+    FDECL(z);
+
+    (void) z_C;
+
+    z_S = sign;
+    FZERO(z);
+
+    FRETURN(z);
+}
+#endif
+
+#define fcproducts __FPFUN_STATIC(cproducts)
+
+/*
+ * calculates the products `p = {ac, bd, ad, bc}` (and `cc, dd` if `n` is 6), returns true if all of them are finite.
+ * The results and exceptions are the same as those of `fmul_st`.
+ */
+static inline bool fcproducts(fsrc_t p[], int n, fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d, int rm, uint8_t *status) {
+    FCDECL(fa);
+    FCDECL(fb);
+    FCDECL(fc);
+    FCDECL(fd);
+
+    FCUNPACK(fa, a);
+    FCUNPACK(fb, b);
+    FCUNPACK(fc, c);
+    FCUNPACK(fd, d);
+
+    if (!FCFINITE(fa) || !FCFINITE(fb) || !FCFINITE(fc) || !FCFINITE(fd)) {
+        p[0] = fmul_st(a, c, rm, status);
+        p[1] = fmul_st(b, d, rm, status);
+        p[2] = fmul_st(a, d, rm, status);
+        p[3] = fmul_st(b, c, rm, status);
+
+        if (n > 4) {
+            p[4] = fmul_st(c, c, rm, status);
+            p[5] = fmul_st(d, d, rm, status);
+        }
+
+        return false;
+    }
+
+    uint8_t st = 0;
+
+    if (FCDENORMAL(fa) || FCDENORMAL(fb) || FCDENORMAL(fc) || FCDENORMAL(fd))
+        st |= SOFTFP_STATUS_DENORM;
+
+    p[0] = FCMUL(fa, fc, &st);
+    p[1] = FCMUL(fb, fd, &st);
+    p[2] = FCMUL(fa, fd, &st);
+    p[3] = FCMUL(fb, fc, &st);
+
+    if (n > 4) {
+        p[4] = FCMUL(fc, fc, &st);
+        p[5] = FCMUL(fd, fd, &st);
+    }
+
+    STATUS_RAISE(st);
+
+    return !(st & SOFTFP_STATUS_OVERFLOW);
+}
+
+#define fmulc_st __FPFUN_STATIC(mulc_st)
+#define fdivc_st __FPFUN_STATIC(divc_st)
+
+static inline void fmulc_st(fsrc_t *re, fsrc_t *im, fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d, int rm, uint8_t *status) {
+    fsrc_t p[4];
+
+    // the sums of finite products cannot be NaN, so the recovery below is only needed if a product is infinite
+    bool finite = fcproducts(p, 4, a, b, c, d, rm, status);
+
+    fsrc_t ac = p[0];
+    fsrc_t bd = p[1];
+    fsrc_t ad = p[2];
+    fsrc_t bc = p[3];
+    fsrc_t x = fsub_st(ac, bd, rm, status);
+    fsrc_t y = fadd_st(ad, bc, rm, status);
+
+    if (finite) {
+        *re = x;
+        *im = y;
+        return;
+    }
 
     FDECL(fa);
     FDECL(fb);
@@ -75,7 +187,7 @@ fcomplex_t fmulc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
     FUNPACK(fy, y);
 
     if (fx_C == FCLS_SNAN || fy_C == FCLS_SNAN)
-        feraiseexcept(FE_INVALID);
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);
 
     if ((fx_C == FCLS_QNAN || fx_C == FCLS_SNAN) && (fy_C == FCLS_QNAN || fy_C == FCLS_SNAN)) {
         int recalc = 0;
@@ -86,10 +198,13 @@ fcomplex_t fmulc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
         FDECL(f1);
         FDECL(f0);
 
+        f1_S = 0;
+        f0_S = 0;
+
         FZERO(f1);
         FZERO(f0);
 
-        f1_E = FBIAS(FEXP);
+        f1_E = 0;
         FSET_JBIT(f1, 1);
 
         FPACK(f1, v1);
@@ -105,64 +220,78 @@ fcomplex_t fmulc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
         FUNPACK(fbc, bc);
 
         if (fa_C == FCLS_INF || fb_C == FCLS_INF) {
-            a = __copysign(fa_C == FCLS_INF ? v1 : v0, a);
-            b = __copysign(fb_C == FCLS_INF ? v1 : v0, b);
+            a = fcopysign(fa_C == FCLS_INF ? v1 : v0, a);
+            b = fcopysign(fb_C == FCLS_INF ? v1 : v0, b);
 
             if (fc_C == FCLS_QNAN || fc_C == FCLS_SNAN)
-                c = __copysign(v0, c);
+                c = fcopysign(v0, c);
 
             if (fd_C == FCLS_QNAN || fd_C == FCLS_SNAN)
-                d = __copysign(v0, d);
+                d = fcopysign(v0, d);
 
             recalc = 1;
         }
 
         if (fc_C == FCLS_INF || fd_C == FCLS_INF) {
-            c = __copysign(fc_C == FCLS_INF ? v1 : v0, c);
-            d = __copysign(fd_C == FCLS_INF ? v1 : v0, d);
+            c = fcopysign(fc_C == FCLS_INF ? v1 : v0, c);
+            d = fcopysign(fd_C == FCLS_INF ? v1 : v0, d);
 
             if (fa_C == FCLS_QNAN || fa_C == FCLS_SNAN)
-                a = __copysign(v0, a);
+                a = fcopysign(v0, a);
 
             if (fb_C == FCLS_QNAN || fb_C == FCLS_SNAN)
-                b = __copysign(v0, b);
+                b = fcopysign(v0, b);
 
             recalc = 1;
         }
 
         if (!recalc && (fac_C == FCLS_INF || fbd_C == FCLS_INF || fad_C == FCLS_INF || fbc_C == FCLS_INF)) {
             if (fa_C == FCLS_QNAN || fa_C == FCLS_SNAN)
-                a = __copysign(v0, a);
+                a = fcopysign(v0, a);
 
             if (fb_C == FCLS_QNAN || fb_C == FCLS_SNAN)
-                b = __copysign(v0, b);
+                b = fcopysign(v0, b);
 
             if (fc_C == FCLS_QNAN || fc_C == FCLS_SNAN)
-                c = __copysign(v0, c);
+                c = fcopysign(v0, c);
 
             if (fd_C == FCLS_QNAN || fd_C == FCLS_SNAN)
-                d = __copysign(v0, d);
+                d = fcopysign(v0, d);
 
             recalc = 1;
         }
 
         if (recalc) {
-            ac = fmul(a, c);
-            bd = fmul(b, d);
-            ad = fmul(a, d);
-            bc = fmul(b, c);
+            ac = fmul_st(a, c, rm, status);
+            bd = fmul_st(b, d, rm, status);
+            ad = fmul_st(a, d, rm, status);
+            bc = fmul_st(b, c, rm, status);
 
             fsrc_t inf;
 
             FDECL(finf);
-            FINF(finf);
+            finf_S = 0;
+        FINF(finf);
             FPACK(finf, inf);
 
-            x = fmul(inf, fsub(ac, bd));
-            y = fmul(inf, fadd(ad, bc));
+            x = fmul_st(inf, fsub_st(ac, bd, rm, status), rm, status);
+            y = fmul_st(inf, fadd_st(ad, bc, rm, status), rm, status);
         }
     }
 
+    *re = x;
+    *im = y;
+}
+
+__FPFUN_LINKAGE fcomplex_t fmulc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
+    uint8_t status_word = 0;
+    fsrc_t x, y;
+
+    fmulc_st(&x, &y, a, b, c, d, fegetround(), &status_word);
+
+    if (status_word)
+        __softfp_merge_status(status_word);
+
     return Complex(x, y);
 }
 
@@ -176,7 +305,7 @@ fcomplex_t fmulc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
             FZERO(x);                                                                                                  \
     } while (0)
 
-fcomplex_t fdivc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
+static inline void fdivc_st(fsrc_t *re, fsrc_t *im, fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d, int rm, uint8_t *status) {
     FDECL(fa);
     FDECL(fb);
     FDECL(fc);
@@ -191,7 +320,7 @@ fcomplex_t fdivc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
     FUNPACK(fc, c);
     FUNPACK(fd, d);
 
-    int32_t ilogb;
+    int32_t ilogb = 0;
     bool logb_inf = false;
 
     if (fd_C == FCLS_QNAN || fd_C == FCLS_SNAN) {
@@ -205,7 +334,7 @@ fcomplex_t fdivc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
             goto nonfinite;
         }
     } else {
-        if (fcmp(c, d) > 0) {
+        if (fcmp_st(c, d, status) > 0) {
             if (fc_C == FCLS_INF) {
                 logb_inf = true;
                 goto nonfinite;
@@ -229,15 +358,19 @@ fcomplex_t fdivc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
     FPACK(fd, d);
 
 nonfinite:;
-    fsrc_t ac = fmul(a, c);
-    fsrc_t bd = fmul(b, d);
-    fsrc_t ad = fmul(a, d);
-    fsrc_t bc = fmul(b, c);
+    fsrc_t p[6];
+
+    fcproducts(p, 6, a, b, c, d, rm, status);
+
+    fsrc_t ac = p[0];
+    fsrc_t bd = p[1];
+    fsrc_t ad = p[2];
+    fsrc_t bc = p[3];
 
-    fsrc_t denom = fadd(fmul(c, c), fmul(d, d));
+    fsrc_t denom = fadd_st(p[4], p[5], rm, status);
 
-    fsrc_t x = fdiv(fadd(ac, bd), denom);
-    fsrc_t y = fdiv(fsub(bc, ad), denom);
+    fsrc_t x = fdiv_st(fadd_st(ac, bd, rm, status), denom, rm, status);
+    fsrc_t y = fdiv_st(fsub_st(bc, ad, rm, status), denom, rm, status);
 
     FUNPACK(fx, x);
     FUNPACK(fy, y);
@@ -260,6 +393,7 @@ nonfinite:;
         fsrc_t inf;
 
         FDECL(finf);
+        finf_S = 0;
         FINF(finf);
         FPACK(finf, inf);
 
@@ -269,10 +403,13 @@ nonfinite:;
         FDECL(f1);
         FDECL(f0);
 
+        f1_S = 0;
+        f0_S = 0;
+
         FZERO(f1);
         FZERO(f0);
 
-        f1_E = FBIAS(FEXP);
+        f1_E = 0;
         FSET_JBIT(f1, 1);
 
         FPACK(f1, v1);
@@ -280,31 +417,44 @@ nonfinite:;
 
         if (fdenom_C == FCLS_ZERO &&
             (!(fx_C == FCLS_SNAN || fx_C == FCLS_QNAN) || !(fy_C == FCLS_SNAN || fy_C == FCLS_QNAN))) {
-            x = fmul(__copysign(inf, c), a);
-            y = fmul(__copysign(inf, c), b);
+            x = fmul_st(fcopysign(inf, c), a, rm, status);
+            y = fmul_st(fcopysign(inf, c), b, rm, status);
         } else if ((fa_C == FCLS_INF || fb_C == FCLS_INF) &&
                    (fc_C != FCLS_QNAN && fc_C != FCLS_SNAN && fc_C != FCLS_INF) &&
                    (fd_C != FCLS_QNAN && fd_C != FCLS_SNAN && fd_C != FCLS_INF)) {
-            a = __copysign(fa_C == FCLS_INF ? v1 : v0, a);
-            b = __copysign(fb_C == FCLS_INF ? v1 : v0, b);
-            x = fmul(inf, fadd(fmul(a, c), fmul(b, d)));
-            y = fmul(inf, fsub(fmul(b, c), fmul(a, d)));
+            a = fcopysign(fa_C == FCLS_INF ? v1 : v0, a);
+            b = fcopysign(fb_C == FCLS_INF ? v1 : v0, b);
+            x = fmul_st(inf, fadd_st(fmul_st(a, c, rm, status), fmul_st(b, d, rm, status), rm, status), rm, status);
+            y = fmul_st(inf, fsub_st(fmul_st(b, c, rm, status), fmul_st(a, d, rm, status), rm, status), rm, status);
         } else if (logb_inf && (fa_C != FCLS_QNAN && fa_C != FCLS_SNAN && fa_C != FCLS_INF) &&
                    (fb_C != FCLS_QNAN && fb_C != FCLS_SNAN && fb_C != FCLS_INF)) {
-            c = __copysign(fc_C == FCLS_INF ? v1 : v0, c);
-            d = __copysign(fd_C == FCLS_INF ? v1 : v0, d);
-            x = fmul(v0, fadd(fmul(a, c), fmul(b, d)));
-            y = fmul(v0, fsub(fmul(b, c), fmul(a, d)));
+            c = fcopysign(fc_C == FCLS_INF ? v1 : v0, c);
+            d = fcopysign(fd_C == FCLS_INF ? v1 : v0, d);
+            x = fmul_st(v0, fadd_st(fmul_st(a, c, rm, status), fmul_st(b, d, rm, status), rm, status), rm, status);
+            y = fmul_st(v0, fsub_st(fmul_st(b, c, rm, status), fmul_st(a, d, rm, status), rm, status), rm, status);
         }
     }
 
+    *re = x;
+    *im = y;
+}
+
+__FPFUN_LINKAGE fcomplex_t fdivc(fsrc_t a, fsrc_t b, fsrc_t c, fsrc_t d) {
+    uint8_t status_word = 0;
+    fsrc_t x, y;
+
+    fdivc_st(&x, &y, a, b, c, d, fegetround(), &status_word);
+
+    if (status_word)
+        __softfp_merge_status(status_word);
+
     return Complex(x, y);
 }
 
-fcomplex_t fcmulc(fcomplex_t a, fcomplex_t b) {
+__FPFUN_LINKAGE fcomplex_t fcmulc(fcomplex_t a, fcomplex_t b) {
     return fmulc(Re(a), Im(a), Re(b), Im(b));
 }
 
-fcomplex_t fcdivc(fcomplex_t a, fcomplex_t b) {
+__FPFUN_LINKAGE fcomplex_t fcdivc(fcomplex_t a, fcomplex_t b) {
     return fdivc(Re(a), Im(a), Re(b), Im(b));
 }
@@ -21,8 +21,6 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
 #include "common_source.h"
 
@@ -37,30 +35,30 @@
             goto zeroval;                                                                                              \
                                                                                                                        \
         if (x_C == FCLS_SNAN || x_C == FCLS_QNAN || x_C == FCLS_INF) {                                                 \
-            feraiseexcept(FE_INVALID);                                                                                 \
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);                                                                       \
             goto errval;                                                                                               \
         }                                                                                                              \
                                                                                                                        \
         if (x_E < 0 || (unsigned_ && x_S)) {                                                                           \
-            feraiseexcept(FE_INEXACT);                                                                                 \
+            STATUS_RAISE(SOFTFP_STATUS_INEXACT);                                                                       \
             goto zeroval;                                                                                              \
         }                                                                                                              \
                                                                                                                        \
         if (x_E >= (bits)) {                                                                                           \
-            feraiseexcept(FE_INEXACT);                                                                                 \
+            STATUS_RAISE(SOFTFP_STATUS_INEXACT);                                                                       \
             goto errval;                                                                                               \
         }                                                                                                              \
                                                                                                                        \
         int round = ARRAY_RSHIFT(x_F, FFRAC - x_E);                                                                    \
-        bool truncated = SHOULD_ROUND(x_S, round);                                                                     \
+        bool truncated = round != 0;                                                                                   \
                                                                                                                        \
         if (ARRAY_MSB(x_F) >= (bits)) {                                                                                \
-            feraiseexcept(FE_INEXACT);                                                                                 \
+            STATUS_RAISE(SOFTFP_STATUS_INEXACT);                                                                       \
             goto errval;                                                                                               \
         }                                                                                                              \
                                                                                                                        \
         if (truncated)                                                                                                 \
-            feraiseexcept(FE_INEXACT);                                                                                 \
+            STATUS_RAISE(SOFTFP_STATUS_INEXACT);                                                                       \
     } while (0)
 
 #define CONV2INT(nanval, type, unsigned_)                                                                              \
@@ -81,23 +79,39 @@
         return 0;                                                                                                      \
     } while (0)
 
-int32_t ffixi32(fsrc_t a) {
+__FPFUN_LINKAGE int32_t ffixi32_st(fsrc_t a, uint8_t *status) {
     CONV2INT(INT32_MIN, int32_t, false);
 }
 
-int64_t ffixi64(fsrc_t a) {
+__FPFUN_LINKAGE int64_t ffixi64_st(fsrc_t a, uint8_t *status) {
     CONV2INT(INT64_MIN, int64_t, false);
 }
 
-uint32_t ffixu32(fsrc_t a) {
+__FPFUN_LINKAGE uint32_t ffixu32_st(fsrc_t a, uint8_t *status) {
     CONV2INT(0, uint32_t, true);
 }
 
-uint64_t ffixu64(fsrc_t a) {
+__FPFUN_LINKAGE uint64_t ffixu64_st(fsrc_t a, uint8_t *status) {
     CONV2INT(0, uint64_t, true);
 }
 
-#define BASE_CONV2FLOAT(unsigned_, nbytes, is_zero, a_negative, a_abs, value)                                          \
+__FPFUN_LINKAGE int32_t ffixi32(fsrc_t a) {
+    STATUS_RETURN(int32_t, ffixi32_st(a, status));
+}
+
+__FPFUN_LINKAGE int64_t ffixi64(fsrc_t a) {
+    STATUS_RETURN(int64_t, ffixi64_st(a, status));
+}
+
+__FPFUN_LINKAGE uint32_t ffixu32(fsrc_t a) {
+    STATUS_RETURN(uint32_t, ffixu32_st(a, status));
+}
+
+__FPFUN_LINKAGE uint64_t ffixu64(fsrc_t a) {
+    STATUS_RETURN(uint64_t, ffixu64_st(a, status));
+}
+
+#define BASE_CONV2FLOAT(unsigned_, nbytes, is_zero, a_negative, a_abs, value, rm)                                      \
     do {                                                                                                               \
         FDECL(z);                                                                                                      \
                                                                                                                        \
@@ -113,56 +127,72 @@ uint64_t ffixu64(fsrc_t a) {
         } else                                                                                                         \
             z_S = 0;                                                                                                   \
                                                                                                                        \
-        int32_t msb = __softfp_revbitscan((uint8_t *) (value), (nbytes));                                              \
-                                                                                                                       \
-        if (msb > FMAXEXP(FEXP)) {                                                                                     \
-            FINF(z);                                                                                                   \
-            goto done;                                                                                                 \
-        }                                                                                                              \
-                                                                                                                       \
-        int round;                                                                                                     \
-                                                                                                                       \
-        if (sizeof z_F < (nbytes)) {                                                                                   \
-            uint32_t buffer[(nbytes)];                                                                                 \
+        {                                                                                                              \
+            /* the integer is the significand of a value with exponent FFRAC */                                        \
+            limb_t buffer[MAX(BYTES_TO_LIMBS((size_t) (nbytes)), sizeof z_F / sizeof *z_F)];                           \
+            memset(buffer, 0, sizeof buffer);                                                                          \
             memcpy(buffer, (value), (nbytes));                                                                         \
-            round = ARRAY_LSHIFT(buffer, FFRAC - msb);                                                                 \
+                                                                                                                       \
+            z_E = FFRAC;                                                                                               \
+            FROUND_AND_NORMALIZE(z, buffer, 0, (rm));                                                                  \
             memcpy(z_F, buffer, sizeof z_F);                                                                           \
-        } else {                                                                                                       \
-            memset(z_F, 0, sizeof z_F);                                                                                \
-            memcpy(z_F, (value), (nbytes));                                                                            \
-            round = ARRAY_LSHIFT(z_F, FFRAC - msb);                                                                    \
         }                                                                                                              \
                                                                                                                        \
-        bool truncated = SHOULD_ROUND(z_S, round);                                                                     \
-                                                                                                                       \
-        if (truncated)                                                                                                 \
-            feraiseexcept(FE_INEXACT);                                                                                 \
-                                                                                                                       \
-        z_E = msb;                                                                                                     \
-                                                                                                                       \
     done:                                                                                                              \
         FRETURN(z);                                                                                                    \
     } while (0)
 
-#define CONV2FLOAT(unsigned_) BASE_CONV2FLOAT(unsigned_, sizeof a, a == 0, a < 0, a = -a, &a)
+#define CONV2FLOAT(unsigned_, rm) BASE_CONV2FLOAT(unsigned_, sizeof a, a == 0, a < 0, a = -a, &a, (rm))
 
-fsrc_t ffloati32(int32_t a) {
-    CONV2FLOAT(false);
+__FPFUN_LINKAGE fsrc_t ffloati32_st(int32_t a, int rm, uint8_t *status) {
+    CONV2FLOAT(false, rm);
 }
 
-fsrc_t ffloati64(int64_t a) {
-    CONV2FLOAT(false);
+__FPFUN_LINKAGE fsrc_t ffloati64_st(int64_t a, int rm, uint8_t *status) {
+    CONV2FLOAT(false, rm);
 }
 
-fsrc_t ffloatu32(uint32_t a) {
-    CONV2FLOAT(true);
+__FPFUN_LINKAGE fsrc_t ffloatu32_st(uint32_t a, int rm, uint8_t *status) {
+    CONV2FLOAT(true, rm);
 }
 
-fsrc_t ffloatu64(uint64_t a) {
-    CONV2FLOAT(true);
+__FPFUN_LINKAGE fsrc_t ffloatu64_st(uint64_t a, int rm, uint8_t *status) {
+    CONV2FLOAT(true, rm);
 }
 
-void ffixbit(void *r, int32_t rprec, fsrc_t a) {
+__FPFUN_LINKAGE fsrc_t ffloati32_rm(int32_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloati32_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati32(int32_t a) {
+    return ffloati32_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati64_rm(int64_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloati64_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati64(int64_t a) {
+    return ffloati64_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu32_rm(uint32_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloatu32_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu32(uint32_t a) {
+    return ffloatu32_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu64_rm(uint64_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloatu64_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu64(uint64_t a) {
+    return ffloatu64_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE void ffixbit_st(void *r, int32_t rprec, fsrc_t a, uint8_t *status) {
     FDECL(x);
 
     if (!rprec)
@@ -189,10 +219,20 @@ zeroval:
     memset(r, 0, BITS_TO_BYTES(rprec));
 }
 
-fsrc_t ffloatbit(const void *r, int32_t rprec) {
+__FPFUN_LINKAGE void ffixbit(void *r, int32_t rprec, fsrc_t a) {
+    uint8_t status = 0;
+
+    ffixbit_st(r, rprec, a, &status);
+
+    if (status)
+        __softfp_merge_status(status);
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatbit_st(const void *r, int32_t rprec, int rm, uint8_t *status) {
     if (!rprec) {
         FDECL(z);
         FZERO(z);
+        z_S = 0;
         FRETURN(z);
     }
 
@@ -202,5 +242,13 @@ fsrc_t ffloatbit(const void *r, int32_t rprec) {
         rprec = -rprec;
 
     BASE_CONV2FLOAT(unsigned_, BITS_TO_BYTES(rprec), MEM_IS_ZERO(r, BITS_TO_BYTES(rprec)),
-                    ((uint8_t *) r)[0] & (1 << (rprec & 7)), ((uint8_t *) r)[0] &= ~(1 << (rprec & 7)), r);
+                    ((uint8_t *) r)[0] & (1 << (rprec & 7)), ((uint8_t *) r)[0] &= ~(1 << (rprec & 7)), r, rm);
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatbit_rm(const void *r, int32_t rprec, int rm) {
+    STATUS_RETURN(fsrc_t, ffloatbit_st(r, rprec, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatbit(const void *r, int32_t rprec) {
+    return ffloatbit_rm(r, rprec, fegetround());
 }
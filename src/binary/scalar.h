@@ -0,0 +1,359 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "../lsp.h"
+#include "../misc/arith.h"
+#include "../misc/misc.h"
+#include "common_source.h"
+
+/*
+ * native-integer implementations of the basic arithmetic for formats which fit into a single limb (binary16, binary32
+ * and binary64). Instead of unpacking into limb arrays, the significands are kept in a single limb with the most
+ * significant bit at bit 62, which leaves bit 63 for carries and 62 - FFRAC bits below the significand for rounding.
+ */
+
+#define FSCALAR ((FBITS == 16 || FBITS == 32 || FBITS == 64) && FJBIT == 0 && LIMB_BITS == 64)
+
+#if FSCALAR == 1
+
+#define __FSCALAR_XUINT(B) uint##B##_t
+#define __FSCALAR_UINT(B) __FSCALAR_XUINT(B)
+
+#define fuint_t __FSCALAR_UINT(FBITS)
+
+#define FSCALAR_SIGN ((limb_t) 1 << (FBITS - 1))
+#define FSCALAR_INF ((limb_t) FSPECIALEXP(FEXP) << FFRAC)
+#define FSCALAR_QUIET ((limb_t) 1 << (FFRAC - 1))
+#define FSCALAR_FRAC (((limb_t) 1 << FFRAC) - 1)
+
+#define FSCALAR_EXPMAX ((int32_t) FSPECIALEXP(FEXP)) // biased exponent of infinities and NaNs
+#define FSCALAR_BIAS ((int32_t) FBIAS(FEXP))
+
+#define FSCALAR_RBITS (62 - FFRAC) // number of rounding bits below the significand
+#define FSCALAR_RMASK (((limb_t) 1 << FSCALAR_RBITS) - 1)
+#define FSCALAR_RHALF ((limb_t) 1 << (FSCALAR_RBITS - 1))
+
+#define FSCALAR_DEFAULT_NAN (FSCALAR_SIGN | FSCALAR_INF | FSCALAR_QUIET)
+
+#define fscalar_bits __FPFUN_STATIC(scalar_bits)
+#define fscalar_value __FPFUN_STATIC(scalar_value)
+#define fscalar_shr_jam __FPFUN_STATIC(scalar_shr_jam)
+#define fscalar_unpack __FPFUN_STATIC(scalar_unpack)
+#define fscalar_round_pack __FPFUN_STATIC(scalar_round_pack)
+#define fscalar_nan_check __FPFUN_STATIC(scalar_nan_check)
+#define fscalar_addsub __FPFUN_STATIC(scalar_addsub)
+#define fscalar_mul __FPFUN_STATIC(scalar_mul)
+#define fscalar_mul_finite __FPFUN_STATIC(scalar_mul_finite)
+#define fscalar_div __FPFUN_STATIC(scalar_div)
+
+static inline limb_t fscalar_bits(fsrc_t a) {
+    fuint_t u;
+    memcpy(&u, &a, sizeof u);
+    return u;
+}
+
+static inline fsrc_t fscalar_value(limb_t v) {
+    fuint_t u = (fuint_t) v;
+    fsrc_t a;
+    memcpy(&a, &u, sizeof a);
+    return a;
+}
+
+/* shifts `v` right by `n` bits, collapsing the shifted out bits into bit 0 */
+static inline limb_t fscalar_shr_jam(limb_t v, int32_t n) {
+    if (n >= 64)
+        return v != 0;
+
+    return (v >> n) | ((v & (((limb_t) 1 << n) - 1)) != 0);
+}
+
+/* splits the finite, nonzero magnitude `v` into its biased exponent and its significand (normalized to bit 62) */
+static inline limb_t fscalar_unpack(limb_t v, int32_t *e) {
+    int32_t exp = v >> FFRAC;
+    limb_t sig = v & FSCALAR_FRAC;
+
+    if (exp == 0) { // denormal
+        int32_t shift = FFRAC - msb_limb(sig);
+
+        sig <<= shift;
+        exp = 1 - shift;
+    } else
+        sig |= (limb_t) 1 << FFRAC;
+
+    *e = exp;
+    return sig << FSCALAR_RBITS;
+}
+
+/*
+ * rounds the value `sig * 2^(e - bias - 62)` (where the most significant bit of `sig` is at bit 62) according to `rm`
+ * and packs it
+ */
+static inline fsrc_t fscalar_round_pack(bool sign, int32_t e, limb_t sig, int rm, uint8_t *status) {
+    limb_t incr;
+
+    switch (rm) {
+        case FE_TONEAREST:
+            incr = FSCALAR_RHALF;
+            break;
+        case FE_UPWARD:
+            incr = sign ? 0 : FSCALAR_RMASK;
+            break;
+        case FE_DOWNWARD:
+            incr = sign ? FSCALAR_RMASK : 0;
+            break;
+        default:
+            incr = 0;
+            break;
+    }
+
+    limb_t s = sign ? FSCALAR_SIGN : 0;
+
+    if (e <= 0) {
+        // tininess is detected after rounding (as if the exponent range was unbounded)
+        bool tiny = e < 0 || sig + incr < ((limb_t) 1 << 63);
+
+        sig = fscalar_shr_jam(sig, 1 - e);
+        e = 1;
+
+        if (tiny && (sig & FSCALAR_RMASK))
+            STATUS_RAISE(SOFTFP_STATUS_UNDERFLOW);
+    } else if (e > FSCALAR_EXPMAX - 1 || (e == FSCALAR_EXPMAX - 1 && sig + incr >= ((limb_t) 1 << 63))) {
+        STATUS_RAISE(SOFTFP_STATUS_OVERFLOW | SOFTFP_STATUS_INEXACT);
+
+        // infinity, or the largest finite value if the rounding mode doesn't round away from zero
+        return fscalar_value(s | (FSCALAR_INF - !incr));
+    }
+
+    limb_t rbits = sig & FSCALAR_RMASK;
+
+    if (rbits)
+        STATUS_RAISE(SOFTFP_STATUS_INEXACT);
+
+    sig = (sig + incr) >> FSCALAR_RBITS;
+
+    if (rm == FE_TONEAREST && rbits == FSCALAR_RHALF) // ties to even
+        sig &= ~(limb_t) 1;
+
+    // a carry out of the significand (or into the J-bit of a denormal) increments the exponent
+    return fscalar_value(s + ((limb_t) (e - 1) << FFRAC) + sig);
+}
+
+/* same as FARITHMETIC_NAN_CHECK, returns true if the result is stored in `r` */
+static inline bool fscalar_nan_check(limb_t x, limb_t y, limb_t *r, uint8_t *status) {
+    bool xnan = (x & ~FSCALAR_SIGN) > FSCALAR_INF;
+    bool ynan = (y & ~FSCALAR_SIGN) > FSCALAR_INF;
+
+    if (xnan || ynan) {
+        if ((xnan && !(x & FSCALAR_QUIET)) || (ynan && !(y & FSCALAR_QUIET)))
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);
+
+        *r = (xnan ? x : y) | FSCALAR_QUIET;
+        return true;
+    }
+
+    if ((!(x & FSCALAR_INF) && (x & FSCALAR_FRAC)) || (!(y & FSCALAR_INF) && (y & FSCALAR_FRAC)))
+        STATUS_RAISE(SOFTFP_STATUS_DENORM);
+
+    return false;
+}
+
+static inline fsrc_t fscalar_addsub(fsrc_t a, fsrc_t b, bool sub, int rm, uint8_t *status) {
+    limb_t x = fscalar_bits(a);
+    limb_t y = fscalar_bits(b);
+    limb_t r;
+
+    if (fscalar_nan_check(x, y, &r, status))
+        return fscalar_value(r);
+
+    if (sub)
+        y ^= FSCALAR_SIGN;
+
+    limb_t xm = x & ~FSCALAR_SIGN;
+    limb_t ym = y & ~FSCALAR_SIGN;
+    bool xs = x >> (FBITS - 1);
+    bool ys = y >> (FBITS - 1);
+
+    if (xm == FSCALAR_INF) {
+        if (ym == FSCALAR_INF && xs != ys) {
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);
+            return fscalar_value(FSCALAR_DEFAULT_NAN);
+        }
+
+        return fscalar_value(x);
+    }
+
+    if (ym == FSCALAR_INF)
+        return fscalar_value(y);
+
+    if (!xm && !ym)
+        return fscalar_value(xs == ys ? x : rm == FE_DOWNWARD ? FSCALAR_SIGN : 0);
+
+    if (!ym)
+        return fscalar_value(x);
+
+    if (!xm)
+        return fscalar_value(y);
+
+    // the magnitudes are ordered like their encodings, so that x ends up being the larger one
+
+    if (xm < ym) {
+        limb_t tm = xm;
+        xm = ym;
+        ym = tm;
+        xs = ys;
+    }
+
+    int32_t xe, ye;
+    limb_t xf = fscalar_unpack(xm, &xe);
+    limb_t yf = fscalar_unpack(ym, &ye);
+
+    yf = fscalar_shr_jam(yf, xe - ye);
+
+    if (x >> (FBITS - 1) == y >> (FBITS - 1)) {
+        xf += yf;
+
+        if (xf >> 63) {
+            xf = fscalar_shr_jam(xf, 1);
+            ++xe;
+        }
+    } else {
+        xf -= yf;
+
+        if (!xf) // exact cancellation
+            return fscalar_value(rm == FE_DOWNWARD ? FSCALAR_SIGN : 0);
+
+        int32_t shift = 62 - msb_limb(xf);
+
+        xf <<= shift;
+        xe -= shift;
+    }
+
+    return fscalar_round_pack(xs, xe, xf, rm, status);
+}
+
+/* multiplies the significands `xf` and `yf` (as returned by `fscalar_unpack`) and rounds the product */
+static inline fsrc_t fscalar_mul_finite(limb_t s, int32_t xe, limb_t xf, int32_t ye, limb_t yf, int rm,
+                                        uint8_t *status) {
+    int32_t e = xe + ye - FSCALAR_BIAS;
+
+    // the product (with the most significant bit at bit 124 or 125) shifted right by 62 bits
+#if FBITS == 64
+    limb_t hi, lo = mullimb(xf, yf, &hi);
+    limb_t sig = (hi << 2) | (lo >> 62) | ((lo & (((limb_t) 1 << 62) - 1)) != 0);
+#else
+    limb_t sig = (xf >> 31) * (yf >> 31); // exact, the lower 31 bits of the significands are zero
+#endif
+
+    if (sig >> 63) {
+        sig = fscalar_shr_jam(sig, 1);
+        ++e;
+    }
+
+    return fscalar_round_pack(s, e, sig, rm, status);
+}
+
+static inline fsrc_t fscalar_mul(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+    limb_t x = fscalar_bits(a);
+    limb_t y = fscalar_bits(b);
+    limb_t r;
+
+    if (fscalar_nan_check(x, y, &r, status))
+        return fscalar_value(r);
+
+    limb_t xm = x & ~FSCALAR_SIGN;
+    limb_t ym = y & ~FSCALAR_SIGN;
+    limb_t s = (x ^ y) & FSCALAR_SIGN;
+
+    if ((xm == FSCALAR_INF && !ym) || (!xm && ym == FSCALAR_INF)) {
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);
+        return fscalar_value(FSCALAR_DEFAULT_NAN);
+    }
+
+    if (xm == FSCALAR_INF || ym == FSCALAR_INF)
+        return fscalar_value(s | FSCALAR_INF);
+
+    if (!xm || !ym)
+        return fscalar_value(s);
+
+    int32_t xe, ye;
+    limb_t xf = fscalar_unpack(xm, &xe);
+    limb_t yf = fscalar_unpack(ym, &ye);
+
+    return fscalar_mul_finite(s, xe, xf, ye, yf, rm, status);
+}
+
+static inline fsrc_t fscalar_div(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+    limb_t x = fscalar_bits(a);
+    limb_t y = fscalar_bits(b);
+    limb_t r;
+
+    if (fscalar_nan_check(x, y, &r, status))
+        return fscalar_value(r);
+
+    limb_t xm = x & ~FSCALAR_SIGN;
+    limb_t ym = y & ~FSCALAR_SIGN;
+    limb_t s = (x ^ y) & FSCALAR_SIGN;
+
+    if ((xm == FSCALAR_INF && ym == FSCALAR_INF) || (!xm && !ym)) {
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);
+        return fscalar_value(FSCALAR_DEFAULT_NAN);
+    }
+
+    if (xm == FSCALAR_INF)
+        return fscalar_value(s | FSCALAR_INF);
+
+    if (!ym) {
+        STATUS_RAISE(SOFTFP_STATUS_DIVBYZERO);
+        return fscalar_value(s | FSCALAR_INF);
+    }
+
+    if (ym == FSCALAR_INF || !xm)
+        return fscalar_value(s);
+
+    int32_t xe, ye;
+    limb_t xf = fscalar_unpack(xm, &xe);
+    limb_t yf = fscalar_unpack(ym, &ye);
+    int32_t e = xe - ye + FSCALAR_BIAS;
+
+    if (xf < yf) { // ensures that the quotient is between 1 and 2
+        xf <<= 1;
+        --e;
+    }
+
+    limb_t rem;
+
+    // the quotient (xf * 2^62) / yf, with the remainder collapsed into bit 0
+#if FBITS == 64
+    limb_t q = divlimb(xf >> 2, xf << 62, yf, &rem);
+#else
+    limb_t n = (xf >> 31) << 30; // exact, the lower 31 bits of the significands are zero
+    limb_t q = n / (yf >> 31);
+
+    rem = n % (yf >> 31);
+    q <<= 32;
+#endif
+
+    return fscalar_round_pack(s, e, q | (rem != 0), rm, status);
+}
+
+#endif
@@ -0,0 +1,52 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* order-preserving keys of binary floating-point numbers (see ../sort.h) */
+
+#include "../lsp.h"
+
+#include <string.h>
+
+#define fsortkey __FPFUN_STATIC(sortkey)
+
+/*
+ * The encoding of a non-negative number, read as an unsigned integer, already increases with the value (and for NaNs,
+ * with the quiet bit and the payload), while the encoding of a negative number decreases. Setting the sign bit of
+ * positive numbers and inverting all bits of negative ones thus gives keys that follow IEEE 754 totalOrder. Redundant
+ * binary80 encodings (pseudo-denormals, unnormals, ...) are ordered by their encoding.
+ */
+static void fsortkey(void *key, const void *elem) {
+    uint64_t x[CEILDIV(FBITS, 64)] = {0};
+    memcpy(x, elem, FBITS / 8);
+
+    const size_t top = (FBITS - 1) / 64;
+    const uint64_t sign = (uint64_t) 1 << ((FBITS - 1) % 64);
+
+    if (x[top] & sign) {
+        for (size_t i = 0; i <= top; ++i)
+            x[i] = ~x[i];
+    } else
+        x[top] |= sign;
+
+    memcpy(key, x, FBITS / 8);
+}
@@ -0,0 +1,64 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* batch variant of the conversion (see ../batch.h) */
+
+#include "../misc/convert.h"
+#include "../misc/half.h"
+#include "../misc/pool.h"
+
+/* conversions between binary16, binary32 and binary64 are processed by the lane-parallel kernels in misc/ */
+#if FDEC == 0 && TDEC == 0 && FBITS == 16 && TBITS == 32 && SOFTFP_HALF_SIMD == 1
+#define fconv_kernel(dst, a, n, rm) __softfp_half_extend((uint32_t *) (dst), (a), (n))
+#elif FDEC == 0 && TDEC == 0 && FBITS == 32 && TBITS == 16 && SOFTFP_HALF_SIMD == 1
+#define fconv_kernel(dst, a, n, rm) __softfp_half_trunc((dst), (const uint32_t *) (a), (n), (rm))
+#elif FDEC == 0 && TDEC == 0 && FBITS == 32 && TBITS == 64 && SOFTFP_CONVERT_SIMD == 1
+#define fconv_kernel(dst, a, n, rm) __softfp_convert_sfdf((uint64_t *) (dst), (const uint32_t *) (a), (n))
+#elif FDEC == 0 && TDEC == 0 && FBITS == 64 && TBITS == 32 && SOFTFP_CONVERT_SIMD == 1
+#define fconv_kernel(dst, a, n, rm) __softfp_convert_dfsf((uint32_t *) (dst), (const uint64_t *) (a), (n), (rm))
+#endif
+
+#ifdef fconv_kernel
+static void FBATCH_CHUNK(fconv_n)(void *arg, size_t lo, size_t hi, uint8_t *status) {
+    const softfp_batch_t *job = arg;
+    const fsrc_t *a = job->a;
+    ftgt_t *dst = job->dst;
+
+    *status |= fconv_kernel(dst + lo, a + lo, hi - lo, job->rm);
+}
+
+#undef fconv_kernel
+#else
+static void FBATCH_CHUNK(fconv_n)(void *arg, size_t lo, size_t hi, uint8_t *status) {
+    const softfp_batch_t *job = arg;
+    const fsrc_t *a = job->a;
+    ftgt_t *dst = job->dst;
+
+    for (size_t i = lo; i < hi; ++i)
+        dst[i] = fconv_st(a[i], job->rm, status);
+}
+#endif
+
+__FPFUN_LINKAGE void fconv_n(ftgt_t *dst, const fsrc_t *a, size_t n) {
+    FBATCH_RUN(fconv_n, MAX(sizeof *dst, sizeof *a), dst, a, NULL, NULL, fegetround());
+}
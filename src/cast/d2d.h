@@ -23,7 +23,14 @@
 
 /* convert decimal to decimal */
 
-ftgt_t fconv(fsrc_t src) {
-    ftgt_t x;
+static inline ftgt_t fconv_st(fsrc_t src, int rm, uint8_t *status) {
+    (void) src;
+    (void) rm;
+    (void) status;
+    ftgt_t x = {0};
     return x;
 }
+
+__FPFUN_LINKAGE ftgt_t fconv(fsrc_t src) {
+    STATUS_RETURN(ftgt_t, fconv_st(src, fegetround(), status));
+}
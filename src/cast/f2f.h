@@ -23,7 +23,224 @@
 
 /* convert binary to binary */
 
-ftgt_t fconv(fsrc_t src) {
-    ftgt_t x;
-    return x;
+#include "../lsp.h"
+#include "../misc/arith.h"
+#include "../misc/misc.h"
+
+#ifndef __SOFTFP_CAST_F2F_H
+#define __SOFTFP_CAST_F2F_H
+
+#if LIMB_BITS == 64
+
+/* index of the most significant set bit (v != 0) */
+static inline int32_t msb_dlimb(dlimb_t v) {
+    limb_t hi = (limb_t) (v >> LIMB_BITS);
+    return hi ? LIMB_BITS + msb_limb(hi) : msb_limb((limb_t) v);
+}
+
+/*
+ * converts `v` from a format with `FB` bits (`FE` exponent and `FF` fraction bits) into a format with `TB` bits (`TE`
+ * exponent and `TF` fraction bits), using the native integer type `W` (which has `WB` bits). Both formats must not
+ * have an explicit J-bit. As in scalar.h, the significand is kept with its J-bit at bit `WB - 2`, so that the bits
+ * below the target significand can be used for rounding. The format parameters are compile-time constants at every
+ * call site, so the compiler specializes the function for each pair.
+ */
+#define FCAST_NATIVE(name, W, WB, msb)                                                                                 \
+    static inline W name(W v, int32_t FB, int32_t FE, int32_t FF, int32_t TB, int32_t TE, int32_t TF, int rm,          \
+                         uint8_t *status) {                                                                            \
+        const W one = 1;                                                                                               \
+                                                                                                                       \
+        bool sign = (v >> (FB - 1)) & 1;                                                                               \
+        int32_t exp = (int32_t) (v >> FF) & FSPECIALEXP(FE);                                                           \
+        W sig = v & ((one << FF) - 1);                                                                                 \
+                                                                                                                       \
+        W s = (W) sign << (TB - 1);                                                                                    \
+        W inf = (W) FSPECIALEXP(TE) << TF;                                                                             \
+                                                                                                                       \
+        if (exp == FSPECIALEXP(FE)) {                                                                                  \
+            if (!sig)                                                                                                  \
+                return s | inf;                                                                                        \
+                                                                                                                       \
+            if (!((sig >> (FF - 1)) & 1))                                                                              \
+                STATUS_RAISE(SOFTFP_STATUS_INVALID);                                                                   \
+                                                                                                                       \
+            /* the most significant bits of the payload are kept */                                                    \
+            sig = TF >= FF ? sig << (TF - FF) : sig >> (FF - TF);                                                      \
+            return s | inf | (one << (TF - 1)) | sig;                                                                  \
+        }                                                                                                              \
+                                                                                                                       \
+        if (exp == 0) {                                                                                                \
+            if (!sig)                                                                                                  \
+                return s;                                                                                              \
+                                                                                                                       \
+            STATUS_RAISE(SOFTFP_STATUS_DENORM);                                                                        \
+                                                                                                                       \
+            int32_t shift = FF - msb(sig);                                                                             \
+            sig <<= shift;                                                                                             \
+            exp = 1 - shift;                                                                                           \
+        } else                                                                                                         \
+            sig |= one << FF;                                                                                          \
+                                                                                                                       \
+        exp += FBIAS(TE) - FBIAS(FE);                                                                                  \
+                                                                                                                       \
+        /* every value of the source format is a normal value of the target format */                                 \
+        if (TF >= FF && TE > FE)                                                                                       \
+            return s + ((W) (exp - 1) << TF) + (sig << (TF - FF));                                                     \
+                                                                                                                       \
+        const int32_t rbits = WB - 2 - TF;                                                                             \
+        const W rmask = (one << rbits) - 1;                                                                            \
+        const W rhalf = one << (rbits - 1);                                                                            \
+        const int32_t expmax = FSPECIALEXP(TE);                                                                        \
+                                                                                                                       \
+        W incr;                                                                                                        \
+                                                                                                                       \
+        switch (rm) {                                                                                                  \
+            case FE_TONEAREST:                                                                                         \
+                incr = rhalf;                                                                                          \
+                break;                                                                                                 \
+            case FE_UPWARD:                                                                                            \
+                incr = sign ? 0 : rmask;                                                                               \
+                break;                                                                                                 \
+            case FE_DOWNWARD:                                                                                          \
+                incr = sign ? rmask : 0;                                                                               \
+                break;                                                                                                 \
+            default:                                                                                                   \
+                incr = 0;                                                                                              \
+                break;                                                                                                 \
+        }                                                                                                              \
+                                                                                                                       \
+        sig <<= WB - 2 - FF;                                                                                           \
+                                                                                                                       \
+        if (exp <= 0) {                                                                                                \
+            /* tininess is detected after rounding (as if the exponent range was unbounded) */                         \
+            bool tiny = exp < 0 || sig + incr < (one << (WB - 1));                                                     \
+                                                                                                                       \
+            sig = 1 - exp >= WB ? sig != 0 : (sig >> (1 - exp)) | ((sig & ((one << (1 - exp)) - 1)) != 0);             \
+            exp = 1;                                                                                                   \
+                                                                                                                       \
+            if (tiny && (sig & rmask))                                                                                 \
+                STATUS_RAISE(SOFTFP_STATUS_UNDERFLOW);                                                                 \
+        } else if (exp > expmax - 1 || (exp == expmax - 1 && sig + incr >= (one << (WB - 1)))) {                       \
+            STATUS_RAISE(SOFTFP_STATUS_OVERFLOW | SOFTFP_STATUS_INEXACT);                                              \
+                                                                                                                       \
+            /* infinity, or the largest finite value if the rounding mode doesn't round away from zero */             \
+            return s | (inf - !incr);                                                                                  \
+        }                                                                                                              \
+                                                                                                                       \
+        W rb = sig & rmask;                                                                                            \
+                                                                                                                       \
+        if (rb)                                                                                                        \
+            STATUS_RAISE(SOFTFP_STATUS_INEXACT);                                                                       \
+                                                                                                                       \
+        sig = (sig + incr) >> rbits;                                                                                   \
+                                                                                                                       \
+        if (rm == FE_TONEAREST && rb == rhalf) /* ties to even */                                                      \
+            sig &= ~one;                                                                                               \
+                                                                                                                       \
+        /* a carry out of the significand (or into the J-bit of a denormal) increments the exponent */                \
+        return s + ((W) (exp - 1) << TF) + sig;                                                                        \
+    }
+
+FCAST_NATIVE(__softfp_cast64, uint64_t, 64, msb_limb)
+FCAST_NATIVE(__softfp_cast128, dlimb_t, 128, msb_dlimb)
+
+#endif
+
+#endif
+
+/* pairs of formats without explicit J-bit, which fit into 64 (or 128) bits, are converted using native integers */
+#if LIMB_BITS == 64 && FJBIT == 0 && TJBIT == 0 && FBITS <= 64 && TBITS <= 64
+#define FCAST_NATIVE_TYPE uint64_t
+#define fcast_native __softfp_cast64
+#elif LIMB_BITS == 64 && FJBIT == 0 && TJBIT == 0 && FBITS <= 128 && TBITS <= 128
+#define FCAST_NATIVE_TYPE dlimb_t
+#define fcast_native __softfp_cast128
+#endif
+
+static inline ftgt_t fconv_st(fsrc_t src, int rm, uint8_t *status) {
+    ftgt_t r;
+
+#ifdef FCAST_NATIVE_TYPE
+    FCAST_NATIVE_TYPE v = 0;
+    memcpy(&v, &src, BITS_TO_BYTES(FBITS));
+
+    v = fcast_native(v, FBITS, FEXP, FFRAC, TBITS, TEXP, TFRAC, rm, status);
+
+    memcpy(&r, &v, BITS_TO_BYTES(TBITS));
+#else
+    FDECL(x);
+    FUNPACK(x, src);
+
+    bool z_S = x_S;
+    int32_t z_E;
+    limb_t z_F[BITS_TO_LIMBS(MAX(FFRAC, TFRAC) + 2)] = {0};
+
+    switch (x_C) {
+        case FCLS_ILLEGAL:
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);
+            z_S = 1;
+            z_E = FSPECIALEXP(TEXP) - FBIAS(TEXP);
+            FCOMMON_SET_QNAN(z, TFRAC, 1);
+            break;
+
+        case FCLS_SNAN:
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);
+            /* fall through */
+
+        case FCLS_QNAN:
+            // the most significant bits of the payload are kept
+            memcpy(z_F, x_F, sizeof x_F);
+            FCOMMON_SET_JBIT(z, FFRAC, 0);
+
+            if (TFRAC > FFRAC)
+                ARRAY_LSHIFT(z_F, TFRAC - FFRAC);
+            else
+                ARRAY_RSHIFT(z_F, FFRAC - TFRAC);
+
+            z_E = FSPECIALEXP(TEXP) - FBIAS(TEXP);
+            FCOMMON_SET_QNAN(z, TFRAC, 1);
+            break;
+
+        case FCLS_INF:
+            z_E = FSPECIALEXP(TEXP) - FBIAS(TEXP);
+            break;
+
+        case FCLS_ZERO:
+            z_E = -FBIAS(TEXP);
+            break;
+
+        default:
+            if (x_C != FCLS_NORMAL)
+                STATUS_RAISE(SOFTFP_STATUS_DENORM);
+
+            memcpy(z_F, x_F, sizeof x_F);
+
+            // the significand is interpreted as `z_F * 2^(z_E - TFRAC)`
+            if (TFRAC > FFRAC) {
+                ARRAY_LSHIFT(z_F, TFRAC - FFRAC);
+                z_E = x_E;
+            } else
+                z_E = x_E + TFRAC - FFRAC;
+
+            FCOMMON_ROUND_AND_NORMALIZE(z, z_F, 0, rm, TEXP, TFRAC);
+            break;
+    }
+
+    // infinities and NaNs have their J-bit set
+    if (TJBIT && z_E > FMAXEXP(TEXP))
+        FCOMMON_SET_JBIT(z, TFRAC, 1);
+
+    FCOMMON_PACK(z, r, TBITS, TEXP, TJBIT, TFRAC);
+#endif
+
+    return r;
+}
+
+#ifdef FCAST_NATIVE_TYPE
+#undef FCAST_NATIVE_TYPE
+#undef fcast_native
+#endif
+
+__FPFUN_LINKAGE ftgt_t fconv(fsrc_t src) {
+    STATUS_RETURN(ftgt_t, fconv_st(src, fegetround(), status));
 }
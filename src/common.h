@@ -27,7 +27,19 @@
 #undef __FPFUN_PREFIX
 #endif
 
-#if FDEC == 1 || (defined TDEC && TDEC == 1)
+/* softfp_inline.h uses a separate namespace, so that the inline functions don't clash with the library */
+#ifdef SOFTFP_INLINE
+#if (FDEC == 1 || (defined TDEC && TDEC == 1)) && DREPR_BOTH == 1
+#if FDPD == 1 || (defined TDPD && TDPD == 1)
+#define __FPFUN_PREFIX softfp_dpd_
+#else
+#define __FPFUN_PREFIX softfp_bid_
+#endif
+#else
+#define __FPFUN_PREFIX softfp_
+#endif
+#else
+#if (FDEC == 1 || (defined TDEC && TDEC == 1)) && DREPR_BOTH == 1
 #if FDPD == 1 || (defined TDPD && TDPD == 1)
 #define __FPFUN_PREFIX __dpd_
 #else
@@ -36,6 +48,7 @@
 #else
 #define __FPFUN_PREFIX __
 #endif
+#endif
 
 #define __XX_FPFUN(a, b, c, d, e) a##b##c##d##e
 #define __X_FPFUN(a, b, c, d, e) __XX_FPFUN(a, b, c, d, e)
@@ -43,13 +56,38 @@
 
 #define __FPFUN_DEFAULT(pre, suf) __FPFUN(pre, FID, suf, /**/)
 #define __FPFUN_COMPLEX(kind) __FPFUN(kind, FCID, 3, /**/)
+#define __FPFUN_COMPLEX_SUFFIX(kind, suf) __FPFUN(kind, FCID, suf, /**/)
 #define __FPFUN_CONVERT(kind) __FPFUN(kind, FID, TID, 2)
+#define __FPFUN_CONVERT_SUFFIX(kind, suf) __FPFUN(kind, FID, TID, suf)
+
+/* helper functions with internal linkage (unique per source format, including the decimal encoding) */
+#ifdef __FPFUN_STATIC
+#undef __FPFUN_STATIC
+#endif
+
+#if FDEC == 1 && FDPD == 1
+#define __FPFUN_STATIC(name) __X_FPFUN(__softfp_, name, _dpd_, FID, /**/)
+#elif FDEC == 1
+#define __FPFUN_STATIC(name) __X_FPFUN(__softfp_, name, _bid_, FID, /**/)
+#else
+#define __FPFUN_STATIC(name) __X_FPFUN(__softfp_, name, _, FID, /**/)
+#endif
+
+#ifndef __FPFUN_LINKAGE
+#ifdef SOFTFP_INLINE
+#define __FPFUN_LINKAGE static inline
+#else
+#define __FPFUN_LINKAGE
+#endif
+#endif
 
 #ifdef TDEFINED
 #ifdef CONV_TGT
 #undef CONV_TGT
 #undef CONV_TRUNC
 #undef fconv
+#undef fconv_st
+#undef fconv_n
 #endif
 
 #if TDEC == 1
@@ -63,33 +101,39 @@
 #if (FBITS > TBITS) || (FBITS == TBITS && FDEC == 1)
 #define CONV_TRUNC 1
 #define fconv __FPFUN_CONVERT(trunc)
+#define fconv_st __FPFUN_CONVERT_SUFFIX(trunc, 2_st)
+#define fconv_n __FPFUN_CONVERT_SUFFIX(trunc, 2_n)
 #else
 #define CONV_TRUNC 0
 #define fconv __FPFUN_CONVERT(extend)
+#define fconv_st __FPFUN_CONVERT_SUFFIX(extend, 2_st)
+#define fconv_n __FPFUN_CONVERT_SUFFIX(extend, 2_n)
 #endif
 
-#if CONV_SRC == f && CONV_TGT == f
+#if FDEC == 0 && TDEC == 0
 #include "cast/f2f.h"
-#elif CONV_SRC == f && CONV_TGT == d
+#elif FDEC == 0 && TDEC == 1
 #include "cast/f2d.h"
-#elif CONV_SRC == d && CONV_TGT == f
+#elif FDEC == 1 && TDEC == 0
 #include "cast/d2f.h"
-#elif CONV_SRC == d && CONV_TGT == d
+#elif FDEC == 1 && TDEC == 1
 #include "cast/d2d.h"
 #else
 #error "Invalid conversion config"
 #endif
 
+#include "cast/batch.h"
+
 #else
 
-#ifdef fadd
-#error "fadd shouldn't be defined here"
-#endif
+#ifndef fadd // the names only depend on FID, so they are the same for every source format
 
 #define fadd __FPFUN_DEFAULT(add, 3)
 #define fsub __FPFUN_DEFAULT(sub, 3)
 #define fmul __FPFUN_DEFAULT(mul, 3)
 #define fdiv __FPFUN_DEFAULT(div, 3)
+#define ffma __FPFUN_DEFAULT(fma, 4)
+#define fsqrt __FPFUN_DEFAULT(sqrt, 2)
 #define fneg __FPFUN_DEFAULT(neg, 2)
 #define ffixi32 __FPFUN_DEFAULT(fix, si)
 #define ffixi64 __FPFUN_DEFAULT(fix, di)
@@ -110,14 +154,76 @@
 #define fle __FPFUN_DEFAULT(le, 2)
 #define fgt __FPFUN_DEFAULT(gt, 2)
 
-#if FDEC == 1
-#include "decimal/common_source.h"
-#define CONV_SRC d
-#else
+#define fadd_rm __FPFUN_DEFAULT(add, 3_rm)
+#define fsub_rm __FPFUN_DEFAULT(sub, 3_rm)
+#define fmul_rm __FPFUN_DEFAULT(mul, 3_rm)
+#define fdiv_rm __FPFUN_DEFAULT(div, 3_rm)
+#define ffma_rm __FPFUN_DEFAULT(fma, 4_rm)
+#define fsqrt_rm __FPFUN_DEFAULT(sqrt, 2_rm)
+#define ffloati32_rm __FPFUN_DEFAULT(floatsi, _rm)
+#define ffloati64_rm __FPFUN_DEFAULT(floatdi, _rm)
+#define ffloatu32_rm __FPFUN_DEFAULT(floatunsi, _rm)
+#define ffloatu64_rm __FPFUN_DEFAULT(floatundi, _rm)
+#define ffloatbit_rm __FPFUN_DEFAULT(floatbitint, _rm)
+
+#define fadd_st __FPFUN_DEFAULT(add, 3_st)
+#define fsub_st __FPFUN_DEFAULT(sub, 3_st)
+#define fmul_st __FPFUN_DEFAULT(mul, 3_st)
+#define fdiv_st __FPFUN_DEFAULT(div, 3_st)
+#define ffma_st __FPFUN_DEFAULT(fma, 4_st)
+#define fsqrt_st __FPFUN_DEFAULT(sqrt, 2_st)
+#define ffixi32_st __FPFUN_DEFAULT(fix, si_st)
+#define ffixi64_st __FPFUN_DEFAULT(fix, di_st)
+#define ffixu32_st __FPFUN_DEFAULT(fixuns, si_st)
+#define ffixu64_st __FPFUN_DEFAULT(fixuns, di_st)
+#define ffixbit_st __FPFUN_DEFAULT(fix, bitint_st)
+#define ffloati32_st __FPFUN_DEFAULT(floatsi, _st)
+#define ffloati64_st __FPFUN_DEFAULT(floatdi, _st)
+#define ffloatu32_st __FPFUN_DEFAULT(floatunsi, _st)
+#define ffloatu64_st __FPFUN_DEFAULT(floatundi, _st)
+#define ffloatbit_st __FPFUN_DEFAULT(floatbitint, _st)
+
+#define fadd_n __FPFUN_DEFAULT(add, 3_n)
+#define fsub_n __FPFUN_DEFAULT(sub, 3_n)
+#define fmul_n __FPFUN_DEFAULT(mul, 3_n)
+#define fdiv_n __FPFUN_DEFAULT(div, 3_n)
+#define ffma_n __FPFUN_DEFAULT(fma, 4_n)
+#define fsqrt_n __FPFUN_DEFAULT(sqrt, 2_n)
+#define fneg_n __FPFUN_DEFAULT(neg, 2_n)
+#define ffixi32_n __FPFUN_DEFAULT(fix, si_n)
+#define ffixi64_n __FPFUN_DEFAULT(fix, di_n)
+#define ffixu32_n __FPFUN_DEFAULT(fixuns, si_n)
+#define ffixu64_n __FPFUN_DEFAULT(fixuns, di_n)
+#define ffloati32_n __FPFUN_DEFAULT(floatsi, _n)
+#define ffloati64_n __FPFUN_DEFAULT(floatdi, _n)
+#define ffloatu32_n __FPFUN_DEFAULT(floatunsi, _n)
+#define ffloatu64_n __FPFUN_DEFAULT(floatundi, _n)
+#define fcmp_n __FPFUN_DEFAULT(cmp, 2_n)
+#define fsortkey_n __FPFUN_DEFAULT(sortkey, _n)
+#define fsort_n __FPFUN_DEFAULT(sort, _n)
+
 #define fmulc __FPFUN_COMPLEX(mul)
 #define fdivc __FPFUN_COMPLEX(div)
 #define fcmulc __FPFUN_COMPLEX(cmul)
 #define fcdivc __FPFUN_COMPLEX(cdiv)
+#define fmulc_n __FPFUN_COMPLEX_SUFFIX(mul, 3_n)
+#define fdivc_n __FPFUN_COMPLEX_SUFFIX(div, 3_n)
+
+#define faccinit __FPFUN_DEFAULT(accinit, /**/)
+#define faccadd __FPFUN_DEFAULT(accadd, /**/)
+#define faccmadd __FPFUN_DEFAULT(accmadd, /**/)
+#define faccmerge __FPFUN_DEFAULT(accmerge, /**/)
+#define faccround __FPFUN_DEFAULT(accround, /**/)
+#define faccround_rm __FPFUN_DEFAULT(accround, _rm)
+#define faccround_st __FPFUN_DEFAULT(accround, _st)
+#define fsum_n __FPFUN_DEFAULT(sum, _n)
+#define fdot_n __FPFUN_DEFAULT(dot, _n)
+#endif
+
+#if FDEC == 1
+#include "decimal/common_source.h"
+#define CONV_SRC d
+#else
 #include "binary/common_source.h"
 #define CONV_SRC f
 #endif
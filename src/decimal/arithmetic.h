@@ -21,42 +21,405 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
+#include "../misc/arith.h"
+#include "../misc/divmnu.h"
+#include "../misc/misc.h"
 #include "common_source.h"
 
-#include <stdio.h>
+#include <string.h>
 
-fsrc_t fadd(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    fsrc_t x = {0};
-    return x;
+#define faddsub __FPFUN_STATIC(addsub)
+#define faddsub_bid __FPFUN_STATIC(addsub_bid)
+#define fbid_decode __FPFUN_STATIC(bid_decode)
+#define fbid_encode __FPFUN_STATIC(bid_encode)
+
+#define NWORDS (sizeof z_F / sizeof *z_F)
+
+/* enough limbs for 3 * DPREC + 4 digits (two aligned coefficients, the rounding digits and the carry) */
+#define DWIDE_LIMBS BITS_TO_LIMBS(((3 * DPREC + 4) * 10 + 2) / 3)
+
+/* returns the first NaN operand (quieted) and raises FE_INVALID if either operand is a signaling NaN */
+#define DARITHMETIC_NAN_CHECK(x, y)                                                                                    \
+    do {                                                                                                               \
+        if (x##_C == DCLS_SNAN || y##_C == DCLS_SNAN)                                                                  \
+            STATUS_RAISE(SOFTFP_STATUS_INVALID);                                                                       \
+                                                                                                                       \
+        if (x##_C == DCLS_SNAN || x##_C == DCLS_QNAN) {                                                                \
+            x##_C = DCLS_QNAN;                                                                                         \
+            DRETURN(x);                                                                                                \
+        }                                                                                                              \
+                                                                                                                       \
+        if (y##_C == DCLS_SNAN || y##_C == DCLS_QNAN) {                                                                \
+            y##_C = DCLS_QNAN;                                                                                         \
+            DRETURN(y);                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+/* the result of an invalid operation is the default NaN (positive, without payload) */
+#define DARITHMETIC_INVALID(z)                                                                                         \
+    do {                                                                                                               \
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);                                                                           \
+        z##_S = 0;                                                                                                     \
+        z##_E = DEXP_NAN;                                                                                              \
+        z##_C = DCLS_QNAN;                                                                                             \
+        memset(z##_F, 0, sizeof z##_F);                                                                                \
+    } while (0)
+
+#if FDPD == 0 && FBITS <= 64
+
+/*
+ * For decimal32 and decimal64, the BID coefficient fits into a single 64-bit integer. As long as both operands are
+ * finite and the exact sum fits into the precision of the format, it is computed without unpacking the operands into
+ * limbs. Since the operands are aligned to the smaller exponent (which is also the preferred exponent of the result),
+ * the sum is exact and doesn't raise any exceptions. Otherwise, the general (limb-based) path is taken.
+ */
+
+/* extracts the exponent and the coefficient of a finite number (returns false for infinities and NaNs) */
+static inline bool fbid_decode(uint64_t v, int32_t *e, uint64_t *c) {
+    unsigned comb = (v >> (FBITS - 6)) & 0x1F; // the first five bits of the combination field
+
+    if (comb >= 0x1E)
+        return false;
+
+    if ((comb >> 3) != 3) {
+        *e = (v >> (FSIGN + 3)) & ((1 << (FCOMB - 3)) - 1);
+        *c = v & (((uint64_t) 1 << (FSIGN + 3)) - 1);
+    } else {
+        *e = (v >> (FSIGN + 1)) & ((1 << (FCOMB - 3)) - 1);
+        *c = ((uint64_t) 1 << (FSIGN + 3)) | (v & (((uint64_t) 1 << (FSIGN + 1)) - 1));
+    }
+
+    if (*c >= __softfp_pow10[DPREC]) // non-canonical
+        *c = 0;
+
+    *e -= DBIAS;
+    return true;
 }
 
-fsrc_t fsub(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    fsrc_t x = {0};
-    return x;
+/* encodes a finite number (`c < 10^DPREC`, `DQMIN <= e <= DQMAX`) */
+static inline fsrc_t fbid_encode(bool s, int32_t e, uint64_t c) {
+    uint64_t E = (uint64_t) (e + DBIAS);
+    uint64_t v = (uint64_t) s << (FBITS - 1);
+
+    if ((c >> (FSIGN + 3)) == 0)
+        v |= E << (FSIGN + 3) | c;
+    else
+        v |= (uint64_t) 3 << (FBITS - 3) | E << (FSIGN + 1) | (c & (((uint64_t) 1 << (FSIGN + 1)) - 1));
+
+    fsrc_t r;
+    memcpy(&r, &v, sizeof r);
+    return r;
 }
 
-fsrc_t fmul(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    fsrc_t x = {0};
-    return x;
+/* returns false if the sum can't be computed without rounding (or one of the operands is not finite) */
+static inline bool faddsub_bid(fsrc_t a, fsrc_t b, bool sub, int rm, fsrc_t *r) {
+    uint64_t x = 0, y = 0, xc, yc, zc;
+    int32_t xe, ye;
+
+    memcpy(&x, &a, sizeof a);
+    memcpy(&y, &b, sizeof b);
+
+    if (!fbid_decode(x, &xe, &xc) || !fbid_decode(y, &ye, &yc))
+        return false;
+
+    bool xs = x >> (FBITS - 1);
+    bool ys = (y >> (FBITS - 1)) ^ sub;
+
+    // align the coefficient with the larger exponent to the smaller exponent (the result must stay below 10^19)
+
+    if (xe != ye) {
+        uint64_t *big = xe > ye ? &xc : &yc;
+        uint32_t shift = xe > ye ? xe - ye : ye - xe;
+
+        if (shift >= 19 || *big >= __softfp_pow10[19 - shift])
+            return false;
+
+        *big *= __softfp_pow10[shift];
+    }
+
+    bool zs;
+
+    if (xs == ys) {
+        zc = xc + yc;
+        zs = xs;
+    } else if (xc >= yc) {
+        zc = xc - yc;
+        zs = zc ? xs : rm == FE_DOWNWARD; // exact cancellation
+    } else {
+        zc = yc - xc;
+        zs = ys;
+    }
+
+    if (zc >= __softfp_pow10[DPREC])
+        return false;
+
+    *r = fbid_encode(zs, MIN(xe, ye), zc);
+    return true;
 }
 
-fsrc_t fdiv(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    fsrc_t x = {0};
-    return x;
+#endif
+
+static inline fsrc_t faddsub(fsrc_t a, fsrc_t b, bool sub, int rm, uint8_t *status) {
+#if FDPD == 0 && FBITS <= 64
+    fsrc_t r;
+
+    if (faddsub_bid(a, b, sub, rm, &r))
+        return r;
+#endif
+
+    DDECL(x);
+    DDECL(y);
+    DDECL(z);
+
+    DUNPACK(x, a);
+    DUNPACK(y, b);
+
+    DARITHMETIC_NAN_CHECK(x, y);
+
+    if (sub)
+        y_S = !y_S;
+
+    if (x_C == DCLS_INF && y_C == DCLS_INF && x_S != y_S) {
+        DARITHMETIC_INVALID(z);
+        DRETURN(z);
+    }
+
+    if (x_C == DCLS_INF)
+        DRETURN(x);
+
+    if (y_C == DCLS_INF)
+        DRETURN(y);
+
+    bool x_big = x_E >= y_E;
+
+    // the result has the smaller exponent, unless it doesn't fit into the precision (then it is rounded)
+
+    if ((x_big ? x_C : y_C) == DCLS_ZERO) {
+        if ((x_big ? y_C : x_C) != DCLS_ZERO) {
+            if (x_big)
+                DRETURN(y);
+
+            DRETURN(x);
+        }
+
+        z_S = x_S == y_S ? x_S : rm == FE_DOWNWARD;
+        z_E = MIN(x_E, y_E);
+        z_C = DCLS_ZERO;
+        memset(z_F, 0, sizeof z_F);
+        DRETURN(z);
+    }
+
+    limb_t xw[DWIDE_LIMBS] = {0};
+    limb_t yw[DWIDE_LIMBS] = {0};
+    limb_t zw[DWIDE_LIMBS];
+
+    memcpy(xw, x_F, sizeof x_F);
+    memcpy(yw, y_F, sizeof y_F);
+
+    limb_t *big = x_big ? xw : yw;
+    limb_t *small = x_big ? yw : xw;
+
+    uint32_t shift = x_big ? x_E - y_E : y_E - x_E;
+
+    if ((x_big ? y_C : x_C) == DCLS_ZERO) // only the trailing zeros that fit into the precision are kept
+        shift = MIN(shift, DPREC);
+    else if (shift >= 2 * DPREC + 2) {
+        /*
+         * the smaller operand is less than 10^-(DPREC+2) ulp of the larger one, so it only affects the rounding (like a
+         * sticky bit) and is replaced by a single unit below the rounding digits
+         */
+        memset(small, 0, sizeof xw);
+        small[0] = 1;
+        shift = DPREC + 3;
+    }
+
+    z_E = MAX(x_E, y_E) - (int32_t) shift;
+
+    __softfp_dec_scale(big, DWIDE_LIMBS, shift);
+
+    if (x_S == y_S) {
+        __softfp_add(zw, xw, yw, DWIDE_LIMBS);
+        z_S = x_S;
+    } else {
+        int borrow = __softfp_sub(zw, big, small, DWIDE_LIMBS);
+        z_S = (x_big ? x_S : y_S) ^ borrow;
+
+        if (ARRAY_IS_ZERO(zw)) // exact cancellation
+            z_S = rm == FE_DOWNWARD;
+    }
+
+    DROUND(z, zw, rm);
+    DRETURN(z);
+}
+
+__FPFUN_LINKAGE fsrc_t fadd_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+    return faddsub(a, b, false, rm, status);
+}
+
+__FPFUN_LINKAGE fsrc_t fsub_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+    return faddsub(a, b, true, rm, status);
+}
+
+__FPFUN_LINKAGE fsrc_t fmul_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+    DDECL(x);
+    DDECL(y);
+    DDECL(z);
+
+    DUNPACK(x, a);
+    DUNPACK(y, b);
+
+    DARITHMETIC_NAN_CHECK(x, y);
+
+    z_S = x_S ^ y_S;
+
+    if ((x_C == DCLS_INF && y_C == DCLS_ZERO) || (x_C == DCLS_ZERO && y_C == DCLS_INF)) {
+        DARITHMETIC_INVALID(z);
+        DRETURN(z);
+    }
+
+    if (x_C == DCLS_INF || y_C == DCLS_INF) {
+        z_E = DEXP_INF;
+        z_C = DCLS_INF;
+        memset(z_F, 0, sizeof z_F);
+        DRETURN(z);
+    }
+
+    z_E = x_E + y_E;
+
+    // the full product of the coefficients (at most 2 * DPREC digits), the excess digits are removed by rounding
+
+#if FBITS <= 64 && LIMB_BITS == 64
+    limb_t zw[2];
+    zw[0] = mullimb(x_F[0], y_F[0], &zw[1]);
+#else
+    limb_t zw[2 * NWORDS];
+    __softfp_mul(zw, x_F, y_F, NWORDS);
+#endif
+
+    DROUND(z, zw, rm);
+    DRETURN(z);
+}
+
+__FPFUN_LINKAGE fsrc_t fdiv_st(fsrc_t a, fsrc_t b, int rm, uint8_t *status) {
+    DDECL(x);
+    DDECL(y);
+    DDECL(z);
+
+    DUNPACK(x, a);
+    DUNPACK(y, b);
+
+    DARITHMETIC_NAN_CHECK(x, y);
+
+    z_S = x_S ^ y_S;
+
+    if ((x_C == DCLS_INF && y_C == DCLS_INF) || (x_C == DCLS_ZERO && y_C == DCLS_ZERO)) {
+        DARITHMETIC_INVALID(z);
+        DRETURN(z);
+    }
+
+    if (x_C == DCLS_INF || y_C == DCLS_ZERO) {
+        if (x_C != DCLS_INF)
+            STATUS_RAISE(SOFTFP_STATUS_DIVBYZERO);
+
+        z_E = DEXP_INF;
+        z_C = DCLS_INF;
+        memset(z_F, 0, sizeof z_F);
+        DRETURN(z);
+    }
+
+    limb_t qw[DWIDE_LIMBS + 1] = {0};
+
+    // the preferred exponent of the result (for exact quotients)
+    z_E = x_E - y_E;
+
+    if (x_C == DCLS_ZERO || y_C == DCLS_INF) {
+        if (y_C == DCLS_INF)
+            z_E = DQMIN;
+
+        DROUND(z, qw, rm);
+        DRETURN(z);
+    }
+
+    // the dividend is scaled, so that the quotient has DPREC + 1 or DPREC + 2 digits (the shift is at least 2)
+    uint32_t shift = __softfp_dec_digits(y_F, NWORDS) + DPREC + 1 - __softfp_dec_digits(x_F, NWORDS);
+    bool exact;
+
+    z_E -= (int32_t) shift;
+
+#if FBITS <= 64 && LIMB_BITS == 64
+    // the scaled dividend has at most 2 * DPREC + 1 digits, so a 128/64-bit division suffices
+    limb_t u[2] = {x_F[0], 0};
+    limb_t rem;
+
+    __softfp_dec_scale(u, 2, shift);
+
+    qw[0] = divlimb(u[1], u[0], y_F[0], &rem);
+    exact = rem == 0;
+#else
+    limb_t u[DWIDE_LIMBS + 1] = {0};
+    limb_t rem[NWORDS];
+
+    memcpy(u, x_F, sizeof x_F);
+    __softfp_dec_scale(u, DWIDE_LIMBS, shift);
+
+    size_t n = NWORDS;
+    size_t m = DWIDE_LIMBS;
+
+    while (!y_F[n - 1])
+        --n;
+
+    while (m > n && !u[m - 1])
+        --m;
+
+    __softfp_divmnu(qw, rem, u, y_F, m, n);
+    exact = MEM_IS_ZERO(rem, n * sizeof *rem);
+#endif
+
+    if (exact) // strip the trailing zeros (down to the preferred exponent)
+        z_E += (int32_t) __softfp_dec_strip(qw, DWIDE_LIMBS + 1, shift);
+    else { // append a nonzero digit, so that the remainder is taken into account when rounding
+        muladd_limb(qw, DWIDE_LIMBS + 1, 10, 1);
+        --z_E;
+    }
+
+    DROUND(z, qw, rm);
+    DRETURN(z);
+}
+
+__FPFUN_LINKAGE fsrc_t fadd_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fadd_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fsub_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fsub_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fmul_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fmul_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fdiv_rm(fsrc_t a, fsrc_t b, int rm) {
+    STATUS_RETURN(fsrc_t, fdiv_st(a, b, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t fadd(fsrc_t a, fsrc_t b) {
+    return fadd_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fsub(fsrc_t a, fsrc_t b) {
+    return fsub_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fmul(fsrc_t a, fsrc_t b) {
+    return fmul_rm(a, b, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t fdiv(fsrc_t a, fsrc_t b) {
+    return fdiv_rm(a, b, fegetround());
 }
 
-fsrc_t fneg(fsrc_t a) {
+__FPFUN_LINKAGE fsrc_t fneg(fsrc_t a) {
     (void) a;
     fsrc_t x = {0};
     return x;
@@ -27,18 +27,19 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "../misc/arith.h"
 #include "../misc/misc.h"
 
 #define __X_DBUILDTYPE(B) sdecimal##B##_t
 #define __DBUILDTYPE(B) __X_DBUILDTYPE(B)
 
 typedef enum {
-    DCLS_ZERO,     // E=0 F=0
-    DCLS_DENORMAL, // E=0 F!=0
-    DCLS_NORMAL,   // E>0 E<emax
-    DCLS_INF,      // E=emax F=0
-    DCLS_SNAN,     // E=emax MSB(F)=1
-    DCLS_QNAN,     // E=emax MSB(F)=0
+    DCLS_ZERO,     // finite, F=0
+    DCLS_DENORMAL, // unused
+    DCLS_NORMAL,   // finite, F!=0
+    DCLS_INF,      // E=DEXP_INF
+    DCLS_SNAN,     // E=DEXP_NAN, F=payload
+    DCLS_QNAN,     // E=DEXP_NAN, F=payload
 } dclass_t;
 
 #define DEXP_INF INT32_MAX
@@ -46,8 +47,8 @@ typedef enum {
 
 /*
  * x_S = sign bit
- * x_E = exponent field
- * x_F = significand/mantissa/fraction
+ * x_E = exponent (of the coefficient's least significant digit, i.e. the value is F * 10^E)
+ * x_F = coefficient (binary integer)
  * x_C = classification
  */
 #define DCOMMON_DECL(x, E, F)                                                                                          \
@@ -55,7 +56,7 @@ typedef enum {
     _Static_assert(((F) % 10) == 0, "unsupported significand size");                                                   \
     bool x##_S;                                                                                                        \
     int32_t x##_E;                                                                                                     \
-    uint32_t x##_F[BITS_TO_WORDS((F) + 4) + ((((F) + 4) % 32) != 0)];                                                  \
+    limb_t x##_F[BITS_TO_LIMBS((F) + 4) + ((((F) + 4) % LIMB_BITS) != 0)];                                            \
     dclass_t x##_C;
 
 #define DCOMMON_UNPACK(x, f, E, F, DPD)                                                                                \
@@ -66,15 +67,101 @@ typedef enum {
             __softfp_bid_unpack(&x##_S, x##_F, &x##_E, &x##_C, &(f), E, F);                                            \
     } while (0)
 
-#define DCOMMON_PACK(f, x)                                                                                             \
+#define DCOMMON_PACK(x, f, E, F, DPD)                                                                                  \
     do {                                                                                                               \
-                                                                                                                       \
+        if (DPD)                                                                                                       \
+            __softfp_dpd_pack(x##_S, x##_F, x##_E, x##_C, &(f), E, F);                                                 \
+        else                                                                                                           \
+            __softfp_bid_pack(x##_S, x##_F, x##_E, x##_C, &(f), E, F);                                                 \
     } while (0)
 
-#define DCOMMON_RETURN(f)                                                                                              \
+#define DCOMMON_RETURN(x, E, F, DPD)                                                                                   \
     do {                                                                                                               \
-        fsrc_t;                                                                                                        \
-        FPACK(f                                                                                                        \
+        fsrc_t r;                                                                                                      \
+        DCOMMON_PACK(x, r, E, F, DPD);                                                                                 \
+        return r;                                                                                                      \
     } while (0)
 
+/*
+ * rounds the coefficient `f` (which may be wider than x_F) to the precision of the format and adjusts the exponent, so
+ * that it is between `qmin` and `qmax` (see __softfp_dec_round). Overflows are rounded to infinity (or the largest
+ * finite number), tiny results are rounded to a subnormal number (or zero).
+ */
+#define DCOMMON_ROUND(x, f, rm, P, QMIN, QMAX)                                                                         \
+    do {                                                                                                               \
+        STATUS_RAISE(__softfp_dec_round((f), sizeof(f) / sizeof *(f), &x##_E, x##_S, (rm), (P), (QMIN), (QMAX)));      \
+                                                                                                                       \
+        if (x##_E == DEXP_INF)                                                                                         \
+            x##_C = DCLS_INF;                                                                                          \
+        else                                                                                                           \
+            x##_C = MEM_IS_ZERO((f), sizeof(f)) ? DCLS_ZERO : DCLS_NORMAL;                                             \
+                                                                                                                       \
+        memcpy(x##_F, (f), sizeof x##_F);                                                                              \
+    } while (0)
+
+/* the powers of ten that fit into 64 bits */
+static const uint64_t __softfp_pow10[20] = {
+    UINT64_C(1),
+    UINT64_C(10),
+    UINT64_C(100),
+    UINT64_C(1000),
+    UINT64_C(10000),
+    UINT64_C(100000),
+    UINT64_C(1000000),
+    UINT64_C(10000000),
+    UINT64_C(100000000),
+    UINT64_C(1000000000),
+    UINT64_C(10000000000),
+    UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+    UINT64_C(10000000000000),
+    UINT64_C(100000000000000),
+    UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000),
+    UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000),
+    UINT64_C(10000000000000000000),
+};
+
+/* calculates `f = f * 10^k` (the result must fit into `n` limbs) */
+static inline void __softfp_dec_scale(limb_t f[], size_t n, uint32_t k) {
+    for (; k > 9; k -= 9)
+        muladd_limb(f, n, (limb_t) __softfp_pow10[9], 0);
+
+    muladd_limb(f, n, (limb_t) __softfp_pow10[k], 0);
+}
+
+/* r = 10^k (k <= 38) */
+static inline void __softfp_dec_pow128(uint64_t r[2], unsigned k) {
+    if (k < 20) {
+        r[0] = __softfp_pow10[k];
+        r[1] = 0;
+    } else
+        muladd64(r, __softfp_pow10[19], __softfp_pow10[k - 19], 0);
+}
+
+/* r = a * b (the result must fit into 128 bits) */
+static inline void __softfp_dec_mul128(uint64_t r[2], const uint64_t a[2], uint64_t b) {
+    uint64_t lo[2];
+    muladd64(lo, a[0], b, 0);
+    r[0] = lo[0];
+    r[1] = lo[1] + a[1] * b;
+}
+
+static inline bool __softfp_dec_less128(const uint64_t a[2], const uint64_t b[2]) {
+    return a[1] < b[1] || (a[1] == b[1] && a[0] < b[0]);
+}
+
+/* the leading digit and the two most significant exponent bits of a finite DPD number */
+static inline unsigned __softfp_dpd_lead(unsigned comb, unsigned *expmsb) {
+    if ((comb >> 3) == 3) {
+        *expmsb = (comb >> 1) & 3;
+        return 8 | (comb & 1);
+    }
+
+    *expmsb = comb >> 3;
+    return comb & 7;
+}
+
 #include "packing.h"
+#include "round.h"
@@ -21,7 +21,9 @@
  * SOFTWARE.
  */
 
-#pragma once
+/* included once per source format (fsrc_t is undefined by source_reset.h) */
+#ifndef fsrc_t
+
 #include "common.h"
 
 #define fsrc_t __DBUILDTYPE(FBITS)
@@ -30,8 +32,26 @@
 
 #define DUNPACK(x, a) DCOMMON_UNPACK(x, a, FCOMB, FSIGN, FDPD)
 
+#define DPACK(x, f) DCOMMON_PACK(x, f, FCOMB, FSIGN, FDPD)
+
+#define DRETURN(x) DCOMMON_RETURN(x, FCOMB, FSIGN, FDPD)
+
+#define DROUND(x, f, rm) DCOMMON_ROUND(x, f, rm, DPREC, DQMIN, DQMAX)
+
+#define DPREC (3 * FSIGN / 10 + 1)      // number of digits in the coefficient
+#define DEXPMAX (3 << (FCOMB - 5))      // number of biased exponents
+#define DBIAS (DEXPMAX / 2 + DPREC - 2) // exponent bias
+#define DQMIN (-DBIAS)                  // smallest exponent
+#define DQMAX (DEXPMAX - 1 - DBIAS)     // largest exponent
+
 #if FCAST_ONLY == 0
 #include "arithmetic.h"
 #include "compare.h"
 #include "intconv.h"
+#include "sortkey.h"
+
+#include "../batch.h"
+#include "../sort.h"
+#endif
+
 #endif
@@ -21,55 +21,283 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
+#include "../misc/arith.h"
 #include "common_source.h"
+#include "declet.h"
+
+#include <string.h>
+
+#define CMP_NAN 2
+
+#define cmpimpl __FPFUN_STATIC(cmpimpl)
+#define cmpnan __FPFUN_STATIC(cmpnan)
+#define fcmp_st __FPFUN_STATIC(cmp_st)
+#define fcmp_field __FPFUN_STATIC(cmp_field)
+#define fcmp_classify __FPFUN_STATIC(cmp_classify)
+#define fcmp_digits __FPFUN_STATIC(cmp_digits)
+#define fcmp_coeff __FPFUN_STATIC(cmp_coeff)
+#define fcmp_magnitude __FPFUN_STATIC(cmp_magnitude)
+
+/*
+ * The comparisons work on the encoding (as one or two 64-bit words) instead of unpacking the operands: the result is
+ * decided by the signs, the classes (from the combination field) and the exponents whenever possible. Otherwise,
+ * the coefficients are compared directly if the exponents are equal (declet by declet for DPD), or the positions of
+ * their most significant digits (exponent plus number of digits) are compared. Only if those are equal as well, the
+ * coefficient with the larger exponent is scaled to the smaller exponent (by less than DPREC digits).
+ */
+
+/* extracts `k` bits (k < 64) at bit position `pos` of the encoding `w` */
+static inline uint64_t fcmp_field(const uint64_t w[2], unsigned pos, unsigned k) {
+    uint64_t v = pos >= 64 ? w[1] >> (pos - 64) : (w[0] >> pos) | (pos ? w[1] << (64 - pos) : 0);
+    return v & (((uint64_t) 1 << k) - 1);
+}
+
+/* the value of the `i`-th declet of the trailing significand */
+#define DCMP_DECLET(w, i) __softfp_dpd_decode[fcmp_field((w), 10 * (i), 10)]
+
+/*
+ * classifies the encoding `w` and extracts the biased exponent `e` and the coefficient `c` (BID) or its leading digit
+ * (DPD) of finite numbers
+ */
+static inline dclass_t fcmp_classify(const uint64_t w[2], int32_t *e, uint64_t c[2]) {
+    unsigned comb = fcmp_field(w, FBITS - 6, 5); // the first five bits of the combination field
+
+    if (comb == 0x1F)
+        return fcmp_field(w, FBITS - 7, 1) ? DCLS_SNAN : DCLS_QNAN;
+
+    if (comb == 0x1E)
+        return DCLS_INF;
+
+    c[1] = 0;
+
+#if FDPD
+    unsigned expmsb;
+
+    c[0] = __softfp_dpd_lead(comb, &expmsb);
+    *e = expmsb << (FCOMB - 5) | fcmp_field(w, FSIGN, FCOMB - 5);
+
+    // only the declet 0 decodes to zero, so the coefficient is zero iff all of its bits are
+    if (c[0] || (FSIGN > 64 ? w[0] | fcmp_field(w, 64, FSIGN - 64) : fcmp_field(w, 0, FSIGN)))
+        return DCLS_NORMAL;
+#else
+    uint64_t p[2];
+
+    if ((comb >> 3) != 3) {
+        *e = fcmp_field(w, FSIGN + 3, FCOMB - 3);
+        c[0] = FSIGN + 3 > 64 ? w[0] : fcmp_field(w, 0, FSIGN + 3);
+        c[1] = FSIGN + 3 > 64 ? fcmp_field(w, 64, FSIGN + 3 - 64) : 0;
+    } else {
+        *e = fcmp_field(w, FSIGN + 1, FCOMB - 3);
+        c[0] = FSIGN + 1 > 64 ? w[0] : fcmp_field(w, 0, FSIGN + 1);
+        c[1] = FSIGN + 1 > 64 ? fcmp_field(w, 64, FSIGN + 1 - 64) : 0;
+        c[(FSIGN + 3) / 64] |= (uint64_t) 1 << ((FSIGN + 3) % 64);
+    }
+
+    __softfp_dec_pow128(p, DPREC);
+
+    if ((c[0] | c[1]) && __softfp_dec_less128(c, p)) // non-canonical coefficients are treated as zero
+        return DCLS_NORMAL;
+#endif
+
+    return DCLS_ZERO;
+}
+
+/* the number of digits of a nonzero coefficient */
+static inline int32_t fcmp_digits(const uint64_t w[2], const uint64_t c[2]) {
+#if FDPD
+    if (c[0]) // nonzero leading digit
+        return DPREC;
+
+    for (int i = FSIGN / 10 - 1;; --i) {
+        unsigned d = DCMP_DECLET(w, i);
+
+        if (d)
+            return 3 * i + (d >= 100 ? 3 : d >= 10 ? 2 : 1);
+    }
+#else
+    (void) w;
+
+    uint64_t v = c[1] ? c[1] : c[0];
+    int32_t msb = (c[1] ? 64 : 0) + (v >> 32 ? 32 + msb_limb((limb_t) (v >> 32)) : msb_limb((limb_t) v));
+    uint64_t p[2];
+
+    // d = floor((msb + 1) * log10(2)), so the coefficient has either d or d + 1 digits
+    int32_t d = (msb + 1) * 315653 >> 20;
+
+    __softfp_dec_pow128(p, d);
+    return d + !__softfp_dec_less128(c, p);
+#endif
+}
+
+/* the coefficient of a finite number as a binary integer */
+static inline void fcmp_coeff(uint64_t c[2], const uint64_t w[2]) {
+#if FDPD
+    for (int i = FSIGN / 10 - 1; i >= 0; --i) {
+        __softfp_dec_mul128(c, c, 1000);
+
+        c[0] += DCMP_DECLET(w, i);
+        c[1] += c[0] < DCMP_DECLET(w, i);
+    }
+#else
+    (void) c;
+    (void) w;
+#endif
+}
+
+/* compares the magnitudes of the finite, nonzero numbers `x` and `y` */
+static inline int fcmp_magnitude(const uint64_t x[2], int32_t xe, uint64_t xc[2], const uint64_t y[2], int32_t ye,
+                                 uint64_t yc[2]) {
+    if (xe == ye) {
+#if FDPD
+        if (xc[0] != yc[0]) // the leading digits
+            return xc[0] > yc[0] ? 1 : -1;
+
+        for (int i = FSIGN / 10 - 1; i >= 0; --i) {
+            unsigned dx = DCMP_DECLET(x, i);
+            unsigned dy = DCMP_DECLET(y, i);
+
+            if (dx != dy)
+                return dx > dy ? 1 : -1;
+        }
+
+        return 0;
+#else
+        return __softfp_dec_less128(yc, xc) - __softfp_dec_less128(xc, yc);
+#endif
+    }
 
-int fcmp(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+    // a coefficient has at most DPREC digits, so the larger exponent wins if they are at least DPREC apart
+
+    if (xe - ye >= DPREC)
+        return 1;
+
+    if (ye - xe >= DPREC)
+        return -1;
+
+    // the exponents of the most significant digits (plus one)
+
+    int32_t xa = xe + fcmp_digits(x, xc);
+    int32_t ya = ye + fcmp_digits(y, yc);
+
+    if (xa != ya)
+        return xa > ya ? 1 : -1;
+
+    // align the coefficients (the scaled coefficient has at most DPREC digits)
+
+    fcmp_coeff(xc, x);
+    fcmp_coeff(yc, y);
+
+    uint64_t *big = xe > ye ? xc : yc;
+    int32_t shift = xe > ye ? xe - ye : ye - xe;
+
+    if (shift > 19) {
+        __softfp_dec_mul128(big, big, __softfp_pow10[19]);
+        shift -= 19;
+    }
+
+    __softfp_dec_mul128(big, big, __softfp_pow10[shift]);
+
+    return __softfp_dec_less128(yc, xc) - __softfp_dec_less128(xc, yc);
+}
+
+static inline int cmpimpl(fsrc_t a, fsrc_t b, uint8_t *status) {
+    uint64_t x[2] = {0, 0}, y[2] = {0, 0};
+    uint64_t xc[2], yc[2];
+    int32_t xe, ye;
+
+    memcpy(x, &a, sizeof a);
+    memcpy(y, &b, sizeof b);
+
+    bool xs = fcmp_field(x, FBITS - 1, 1);
+    bool ys = fcmp_field(y, FBITS - 1, 1);
+
+    dclass_t x_C = fcmp_classify(x, &xe, xc);
+    dclass_t y_C = fcmp_classify(y, &ye, yc);
+
+    if (x_C == DCLS_SNAN || y_C == DCLS_SNAN) {
+        STATUS_RAISE(SOFTFP_STATUS_INVALID);
+        return CMP_NAN;
+    }
+
+    if (x_C == DCLS_QNAN || y_C == DCLS_QNAN)
+        return CMP_NAN;
+
+    if (x_C == DCLS_INF) {
+        if (y_C != DCLS_INF || xs != ys)
+            return xs ? -1 : 1;
+
+        return 0;
+    }
+
+    if (y_C == DCLS_INF)
+        return ys ? 1 : -1;
+
+    if (x_C == DCLS_ZERO)
+        return y_C == DCLS_ZERO ? 0 : ys ? 1 : -1;
+
+    if (y_C == DCLS_ZERO)
+        return xs ? -1 : 1;
+
+    if (xs != ys)
+        return xs ? -1 : 1;
+
+    int cmp = fcmp_magnitude(x, xe, xc, y, ye, yc);
+    return xs ? -cmp : cmp;
+}
+
+/* replaces the unordered result of cmpimpl with `nan` */
+static inline int cmpnan(int cmp, int nan) {
+    return cmp == CMP_NAN ? nan : cmp;
 }
 
-int funord(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+static inline int fcmp_st(fsrc_t a, fsrc_t b, uint8_t *status) {
+    return cmpnan(cmpimpl(a, b, status), 1);
+}
+
+__FPFUN_LINKAGE int fcmp(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, fcmp_st(a, b, status));
+}
+
+__FPFUN_LINKAGE int funord(fsrc_t a, fsrc_t b) {
+    uint64_t x[2] = {0, 0}, y[2] = {0, 0};
+
+    memcpy(x, &a, sizeof a);
+    memcpy(y, &b, sizeof b);
+
+    // the first six bits of the combination field are 11111Q for NaNs
+
+    unsigned x_N = fcmp_field(x, FBITS - 7, 6);
+    unsigned y_N = fcmp_field(y, FBITS - 7, 6);
+
+    if (x_N == 0x3F || y_N == 0x3F) {
+        feraiseexcept(FE_INVALID);
+        return 1;
+    }
+
+    return (x_N >> 1) == 0x1F || (y_N >> 1) == 0x1F;
 }
 
-int feq(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+__FPFUN_LINKAGE int feq(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fne(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+__FPFUN_LINKAGE int fne(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fge(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+__FPFUN_LINKAGE int fge(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), -1));
 }
 
-int flt(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+__FPFUN_LINKAGE int flt(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fle(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+__FPFUN_LINKAGE int fle(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), 1));
 }
 
-int fgt(fsrc_t a, fsrc_t b) {
-    (void) a;
-    (void) b;
-    return 0;
+__FPFUN_LINKAGE int fgt(fsrc_t a, fsrc_t b) {
+    STATUS_RETURN(int, cmpnan(cmpimpl(a, b, status), -1));
 }
@@ -21,64 +21,142 @@
  * SOFTWARE.
  */
 
-#pragma once
-
 #include "../lsp.h"
 #include "common_source.h"
 
-int32_t ffixi32(fsrc_t a) {
+__FPFUN_LINKAGE int32_t ffixi32_st(fsrc_t a, uint8_t *status) {
     (void) a;
+    (void) status;
     return 0;
 }
 
-int64_t ffixi64(fsrc_t a) {
+__FPFUN_LINKAGE int64_t ffixi64_st(fsrc_t a, uint8_t *status) {
     (void) a;
+    (void) status;
     return 0;
 }
 
-uint32_t ffixu32(fsrc_t a) {
+__FPFUN_LINKAGE uint32_t ffixu32_st(fsrc_t a, uint8_t *status) {
     (void) a;
+    (void) status;
     return 0;
 }
 
-uint64_t ffixu64(fsrc_t a) {
+__FPFUN_LINKAGE uint64_t ffixu64_st(fsrc_t a, uint8_t *status) {
     (void) a;
+    (void) status;
     return 0;
 }
 
-fsrc_t ffloati32(int32_t a) {
+__FPFUN_LINKAGE int32_t ffixi32(fsrc_t a) {
+    STATUS_RETURN(int32_t, ffixi32_st(a, status));
+}
+
+__FPFUN_LINKAGE int64_t ffixi64(fsrc_t a) {
+    STATUS_RETURN(int64_t, ffixi64_st(a, status));
+}
+
+__FPFUN_LINKAGE uint32_t ffixu32(fsrc_t a) {
+    STATUS_RETURN(uint32_t, ffixu32_st(a, status));
+}
+
+__FPFUN_LINKAGE uint64_t ffixu64(fsrc_t a) {
+    STATUS_RETURN(uint64_t, ffixu64_st(a, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati32_st(int32_t a, int rm, uint8_t *status) {
     (void) a;
+    (void) rm;
+    (void) status;
     fsrc_t x = {0};
     return x;
 }
 
-fsrc_t ffloati64(int64_t a) {
+__FPFUN_LINKAGE fsrc_t ffloati64_st(int64_t a, int rm, uint8_t *status) {
     (void) a;
+    (void) rm;
+    (void) status;
     fsrc_t x = {0};
     return x;
 }
 
-fsrc_t ffloatu32(uint32_t a) {
+__FPFUN_LINKAGE fsrc_t ffloatu32_st(uint32_t a, int rm, uint8_t *status) {
     (void) a;
+    (void) rm;
+    (void) status;
     fsrc_t x = {0};
     return x;
 }
 
-fsrc_t ffloatu64(uint64_t a) {
+__FPFUN_LINKAGE fsrc_t ffloatu64_st(uint64_t a, int rm, uint8_t *status) {
     (void) a;
+    (void) rm;
+    (void) status;
     fsrc_t x = {0};
     return x;
 }
 
-void ffixbit(void *r, int32_t rprec, fsrc_t a) {
+__FPFUN_LINKAGE fsrc_t ffloati32_rm(int32_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloati32_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati32(int32_t a) {
+    return ffloati32_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati64_rm(int64_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloati64_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloati64(int64_t a) {
+    return ffloati64_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu32_rm(uint32_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloatu32_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu32(uint32_t a) {
+    return ffloatu32_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu64_rm(uint64_t a, int rm) {
+    STATUS_RETURN(fsrc_t, ffloatu64_st(a, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatu64(uint64_t a) {
+    return ffloatu64_rm(a, fegetround());
+}
+
+__FPFUN_LINKAGE void ffixbit_st(void *r, int32_t rprec, fsrc_t a, uint8_t *status) {
     (void) r;
     (void) rprec;
     (void) a;
+    (void) status;
 }
 
-fsrc_t ffloatbit(const void *r, int32_t rprec) {
+__FPFUN_LINKAGE void ffixbit(void *r, int32_t rprec, fsrc_t a) {
+    uint8_t status = 0;
+
+    ffixbit_st(r, rprec, a, &status);
+
+    if (status)
+        __softfp_merge_status(status);
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatbit_st(const void *r, int32_t rprec, int rm, uint8_t *status) {
     (void) r;
     (void) rprec;
+    (void) rm;
+    (void) status;
     fsrc_t x = {0};
     return x;
 }
+
+__FPFUN_LINKAGE fsrc_t ffloatbit_rm(const void *r, int32_t rprec, int rm) {
+    STATUS_RETURN(fsrc_t, ffloatbit_st(r, rprec, rm, status));
+}
+
+__FPFUN_LINKAGE fsrc_t ffloatbit(const void *r, int32_t rprec) {
+    return ffloatbit_rm(r, rprec, fegetround());
+}
@@ -24,30 +24,66 @@
 #include "packing.h"
 #include "../misc/arith.h"
 #include "common.h"
+#include "declet.h"
 
 #include <string.h>
 
-#ifdef X86
-#include <immintrin.h>
-#endif
+/* extracts `k` bits (k < 64) at bit position `pos` of the 128-bit word `w` */
+static inline uint64_t get_bits(const uint64_t w[2], size_t pos, size_t k) {
+    uint64_t v = pos >= 64 ? w[1] >> (pos - 64) : (w[0] >> pos) | (pos ? w[1] << (64 - pos) : 0);
+    return v & (((uint64_t) 1 << k) - 1);
+}
+
+/* ORs `v` into the 128-bit word `w` at bit position `pos` */
+static inline void put_bits(uint64_t w[2], size_t pos, uint64_t v) {
+    if (pos >= 64)
+        w[1] |= v << (pos - 64);
+    else {
+        w[0] |= v << pos;
+
+        if (pos)
+            w[1] |= v >> (64 - pos);
+    }
+}
+
+/* the `k` least significant bits of the 128-bit word `w` */
+static inline void get_low(uint64_t r[2], const uint64_t w[2], size_t k) {
+    r[0] = k >= 64 ? w[0] : w[0] & (((uint64_t) 1 << k) - 1);
+    r[1] = k > 64 ? w[1] & (((uint64_t) 1 << (k - 64)) - 1) : 0;
+}
 
-static inline void unpack(bool *restrict sign, uint8_t significand[], int32_t *restrict exponent,
-                          dclass_t *restrict class, uint8_t *restrict data, size_t ncomb, size_t nsig, bool dpd) {
+/* converts between a 128-bit word and `n` limbs */
+static inline void to_limbs(limb_t r[], size_t n, const uint64_t w[2]) {
+    for (size_t i = 0; i < n; ++i) {
+        size_t pos = i * LIMB_BITS;
+        r[i] = pos < 128 ? (limb_t) (w[pos / 64] >> (pos % 64)) : 0;
+    }
+}
 
-    const size_t nbytes = BITS_TO_BYTES(ncomb + nsig + 1);
+static inline void from_limbs(uint64_t r[2], const limb_t a[], size_t n) {
+    r[0] = r[1] = 0;
+
+    for (size_t i = 0; i < n && i * LIMB_BITS < 128; ++i)
+        r[i * LIMB_BITS / 64] |= (uint64_t) a[i] << (i * LIMB_BITS % 64);
+}
 
-    const uint32_t bias = 3 * (1 << (ncomb - 6)) - 1; // = (3 * 2^expbits) / 2 - 1
+static inline void unpack(bool *restrict sign, limb_t significand[], int32_t *restrict exponent,
+                          dclass_t *restrict class, const uint8_t *restrict data, size_t ncomb, size_t nsig, bool dpd) {
 
-    size_t sigbytes = nsig / 8;
-    size_t sigbits = nsig % 8;
+    const size_t nbits = ncomb + nsig + 1;
+    const size_t nlimbs = BITS_TO_LIMBS(nsig + 4) + ((nsig + 4) % LIMB_BITS != 0);
 
-    uint8_t msb = data[nbytes - 1];
+    const uint32_t prec = 3 * nsig / 10 + 1;
+    const int32_t bias = (3 << (ncomb - 6)) + prec - 2; // = (3 * 2^expbits) / 2 + prec - 2
 
-    const size_t ndigits = nsig / 10 * 3 + 1;
-    uint8_t digits[ndigits];
+    // the leading digit (from the combination field), which acts as the most significant declet
+    const size_t ndeclets = nsig / 10 + 1;
+    unsigned lead = 0;
 
-    uint32_t rawexp = 0;
-    size_t offset = 0;
+    uint64_t w[2] = {0, 0};
+    uint64_t c[2], p[2];
+
+    memcpy(w, data, nbits / 8);
 
     /*
      * S = sign bit
@@ -62,368 +98,205 @@ static inline void unpack(bool *restrict sign, uint8_t significand[], int32_t *r
      * S00EEEEE...EFFF   exponent = 00EEE...EEE
      * S01EEEEE...EFFF   exponent = 01EEE...EEE
      * S10EEEEE...EFFF   exponent = 10EEE...EEE
-     * S1100EEE...EEEF   exponent = 00EEE...EEE
-     * S1101EEE...EEEF   exponent = 01EEE...EEE
-     * S1110EEE...EEEF   exponent = 10EEE...EEE
+     * S1100EEE...EEEF   exponent = 00EEE...EEE, significand = 100FFF...FFF
+     * S1101EEE...EEEF   exponent = 01EEE...EEE, significand = 100FFF...FFF
+     * S1110EEE...EEEF   exponent = 10EEE...EEE, significand = 100FFF...FFF
      *
      * DPD:
      *
      * S00FFFEE...EEEE   exponent = 00EEE...EEE
      * S01FFFEE...EEEE   exponent = 01EEE...EEE
      * S10FFFEE...EEEE   exponent = 10EEE...EEE
-     * S1100FEE...EEEE   exponent = 00EEE...EEE
-     * S1101FEE...EEEE   exponent = 01EEE...EEE
-     * S1110FEE...EEEE   exponent = 10EEE...EEE
+     * S1100FEE...EEEE   exponent = 00EEE...EEE, leading digit = 100F
+     * S1101FEE...EEEE   exponent = 01EEE...EEE, leading digit = 100F
+     * S1110FEE...EEEE   exponent = 10EEE...EEE, leading digit = 100F
      *
      * common:
      *
      * S11110xx...xxxx   +-Inf
      * S11111QP...PPPP   NaN (with payload P; qNaN if Q=0, sNaN if Q=1)
+     *
+     * Non-canonical significands (>= 10^prec) and payloads (>= 10^(prec-1)) are treated as zero.
      */
 
-    *sign = !!(msb & 0x80);
-
-    uint32_t exp = msb & 0x60;
-    uint8_t shift;
+    *sign = get_bits(w, nbits - 1, 1);
 
-    if (exp == 0x60) {
-        exp = msb & 0x18;
+    unsigned comb = get_bits(w, nbits - 6, 5);
 
-        if (exp == 0x18) {
-            if (msb & 0x04) {
-                *class = (msb & 0x02) ? DCLS_SNAN : DCLS_QNAN;
-                *exponent = DEXP_NAN;
-                *sign = 0; // ignore sign bit for NaN
+    if (comb == 0x1F) {
+        *class = get_bits(w, nbits - 7, 1) ? DCLS_SNAN : DCLS_QNAN;
+        *exponent = DEXP_NAN;
 
-                if (dpd)
-                    goto unpack_dpd;
-                else
-                    goto unpack_bid;
-            }
+        if (dpd) // the payload has no leading digit
+            goto unpack_dpd;
 
-            *class = DCLS_INF;
-            *exponent = DEXP_INF;
-            return;
-        }
+        get_low(c, w, nsig);
+        __softfp_dec_pow128(p, prec - 1);
+        goto unpack_bid;
+    }
 
-        *class = DCLS_NORMAL;
-        exp >>= 3;
+    if (comb == 0x1E) {
+        *class = DCLS_INF;
+        *exponent = DEXP_INF;
+        memset(significand, 0, nlimbs * sizeof(limb_t));
+        return;
+    }
 
-        if (dpd) {
-            digits[ndigits - 1] = ((msb >> 2) & 1) | 0x8;
-            goto unpack_dpd_exp;
-        }
+    *class = DCLS_NORMAL;
 
-        shift = 1;
-    } else {
-        *class = DCLS_NORMAL;
-        exp >>= 5;
+    if (dpd) {
+        unsigned expmsb;
 
-        if (dpd) {
-            digits[ndigits - 1] = (msb >> 2) & 0x7;
-            goto unpack_dpd_exp;
-        }
+        lead = __softfp_dpd_lead(comb, &expmsb);
+        *exponent = (int32_t) (expmsb << (ncomb - 5) | get_bits(w, nsig, ncomb - 5)) - bias;
+        goto unpack_dpd;
+    }
 
-        shift = 3;
+    if ((comb >> 3) != 3) {
+        *exponent = (int32_t) get_bits(w, nsig + 3, ncomb - 3) - bias;
+        get_low(c, w, nsig + 3);
+    } else {
+        *exponent = (int32_t) get_bits(w, nsig + 1, ncomb - 3) - bias;
+        get_low(c, w, nsig + 1);
+        put_bits(c, nsig + 3, 1);
     }
 
-unpack_bid_exp:;
-    for (size_t i = sigbytes; i < nbytes; ++i) {
-        uint8_t byte = data[i];
+    __softfp_dec_pow128(p, prec);
 
-        if (i == sigbytes) {
-            if (shift + sigbits > 8) {
-                significand[sigbytes] |= byte;
+unpack_bid:
+    if (!__softfp_dec_less128(c, p))
+        c[0] = c[1] = 0;
 
-                offset = shift + sigbits - 8;
-                byte = data[++i];
+    if (*class == DCLS_NORMAL && (c[0] | c[1]) == 0)
+        *class = DCLS_ZERO;
 
-                significand[sigbytes + 1] |= byte & (0xFF << offset);
-            } else {
-                offset = sigbits + shift;
+    to_limbs(significand, nlimbs, c);
+    return;
 
-                significand[sigbytes] |= byte & (0xFF << offset);
+unpack_dpd:;
+    /*
+     * The declets are converted from the most significant one downwards, three at a time: each group is combined into
+     * a base-10^9 digit (which fits into 32 bits), which is then accumulated via c = c * 10^9 + digit. The topmost
+     * group may contain fewer declets (decimal128 has 12 declets including the leading digit, i.e. 4 groups).
+     */
 
-                if (shift == 1) {
-                    if (sigbits < 5)
-                        significand[sigbytes] |= 0x8 << sigbits;
-                    else
-                        significand[sigbytes + 1] |= 0x1 << (sigbits - 5);
-                }
-            }
+    c[0] = c[1] = 0;
 
-            byte >>= offset;
+    for (size_t i = ndeclets, k = (ndeclets - 1) % 3 + 1; i > 0; k = 3) {
+        uint64_t chunk = 0;
 
-            offset = 8 - offset;
-            rawexp = byte;
-            continue;
+        for (size_t j = 0; j < k; ++j) {
+            --i;
+            chunk = chunk * 1000 + (i == ndeclets - 1 ? lead : __softfp_dpd_decode[get_bits(w, 10 * i, 10)]);
         }
 
-        if (i == nbytes - 1) {
-            if (shift == 1) {
-                rawexp |= (byte & 0x07) << offset;
-                offset += 3;
-            } else {
-                rawexp |= (byte & 0x1F) << offset;
-                offset += 5;
-            }
-        } else {
-            rawexp |= byte << offset;
-            offset += 8;
-        }
+        uint64_t hi = c[1] * __softfp_pow10[3 * k];
+
+        muladd64(c, c[0], __softfp_pow10[3 * k], chunk);
+        c[1] += hi;
     }
 
-    *exponent = ((exp << offset) | rawexp) - bias;
+    if (*class == DCLS_NORMAL && (c[0] | c[1]) == 0)
+        *class = DCLS_ZERO;
 
-unpack_bid:
-    memcpy(significand, data, sigbytes);
+    to_limbs(significand, nlimbs, c);
+}
 
-    if (sigbits)
-        significand[sigbytes] |= data[sigbytes] & ((1 << sigbits) - 1);
+static inline void pack(bool sign, const limb_t significand[], int32_t exponent, dclass_t class, uint8_t *restrict data,
+                        size_t ncomb, size_t nsig, bool dpd) {
 
-    // TODO bounds check
+    const size_t nbits = ncomb + nsig + 1;
+    const size_t nlimbs = BITS_TO_LIMBS(nsig + 4) + ((nsig + 4) % LIMB_BITS != 0);
 
-    return;
+    const uint32_t prec = 3 * nsig / 10 + 1;
+    const int32_t bias = (3 << (ncomb - 6)) + prec - 2;
 
-unpack_dpd_exp:;
-    for (size_t i = sigbytes; i < nbytes; ++i) {
-        uint8_t byte = data[i];
-
-        if (i == sigbytes) {
-            byte >>= sigbits;
-            byte <<= offset;
-            offset += sigbits;
-        } else if (i == nbytes - 1) {
-            byte &= 0x03;
-            byte <<= offset;
-            offset += 2;
-        } else {
-            byte <<= offset;
-            offset += 8;
-        }
+    uint64_t w[2] = {0, 0};
+    uint64_t c[2];
 
-        rawexp |= byte;
-    }
+    from_limbs(c, significand, nlimbs);
 
-    *exponent = ((exp << offset) | rawexp) - bias;
+    if (class == DCLS_INF)
+        put_bits(w, nbits - 6, 0x1E);
+    else if (class == DCLS_QNAN || class == DCLS_SNAN) {
+        put_bits(w, nbits - 6, 0x1F);
 
-unpack_dpd:;
-    register size_t digit = 0;
+        if (class == DCLS_SNAN)
+            put_bits(w, nbits - 7, 1);
 
-    for (size_t i = 0; i < nsig / 10; ++i) {
-        size_t offset = 10 * i;
+        if (dpd)
+            goto pack_dpd;
 
-        size_t bitoff = offset % 8;
-        size_t byteoff = offset / 8;
+        w[0] |= c[0];
+        w[1] |= c[1];
+    } else {
+        uint32_t exp = (uint32_t) (exponent + bias);
 
-        register uint16_t block = 0;
+        if (dpd) {
+            limb_t tmp[BITS_TO_LIMBS(128)];
+            uint64_t top[2];
 
-        size_t bit = 0;
+            // the leading digit is the quotient of the division by 10^(prec-1)
+            to_limbs(tmp, BITS_TO_LIMBS(128), c);
 
-        while (bit < 10) {
-            uint8_t byte = data[byteoff];
+            for (size_t i = 0; i < nsig / 10; ++i)
+                divmod_limb(tmp, BITS_TO_LIMBS(128), 1000);
 
-            block |= (byte >> bitoff) << bit;
+            from_limbs(top, tmp, BITS_TO_LIMBS(128));
 
-            bit += 8 - bitoff;
+            unsigned lead = (unsigned) top[0];
+            unsigned expmsb = exp >> (ncomb - 5);
 
-            bitoff = 0;
-            ++byteoff;
+            put_bits(w, nbits - 6, lead < 8 ? expmsb << 3 | lead : 0x18 | expmsb << 1 | (lead & 1));
+            put_bits(w, nsig, exp & ((1 << (ncomb - 5)) - 1));
+            goto pack_dpd;
         }
 
-        uint8_t mode;
-
-#ifdef USE_PEXT
-#undef USE_PEXT
-#endif
-
-#if defined X86 && !defined X86_NO_BMI2
-#define USE_PEXT
-        mode = _pext_u32(block, 0xE);
-#else
-        mode = (block >> 1) & 0x7;
-#endif
-
-        switch (mode) {
-            case 0:
-            case 1:
-            case 2:
-            case 3:
-#ifdef USE_PEXT
-                digits[digit++] = _pext_u32(block, 0x7);   // --- --- 0 111
-                digits[digit++] = _pext_u32(block, 0x70);  // --- 111 0 ---
-                digits[digit++] = _pext_u32(block, 0x380); // 111 --- 0 ---
-#else
-                digits[digit++] = block & 0x7;
-                digits[digit++] = (block >> 4) & 0x7;
-                digits[digit++] = (block >> 7) & 0x7;
-#endif
-                break;
-
-            case 4:
-#ifdef USE_PEXT
-                digits[digit++] = _pext_u32(block, 0x1) | 0x8; // --- --- 100 x
-                digits[digit++] = _pext_u32(block, 0x70);      // --- xxx 100 -
-                digits[digit++] = _pext_u32(block, 0x380);     // xxx --- 100 -
-#else
-                digits[digit++] = 0x8 | (block & 0x1);
-                digits[digit++] = (block >> 4) & 0x7;
-                digits[digit++] = (block >> 7) & 0x7;
-#endif
-                break;
-
-            case 5:
-#ifdef USE_PEXT
-                digits[digit++] = _pext_u32(block, 0x61);       // --- xx- 101 x
-                digits[digit++] = _pext_u32(block, 0x10) | 0x8; // --- --x 101 -
-                digits[digit++] = _pext_u32(block, 0x380);      // xxx --- 101 -
-#else
-                digits[digit++] = (block & 0x1) | ((block >> 4) & 0x6);
-                digits[digit++] = 0x8 | ((block >> 4) & 0x1);
-                digits[digit++] = (block >> 7) & 0x7;
-#endif
-                break;
-
-            case 6:
-#ifdef USE_PEXT
-                digits[digit++] = _pext_u32(block, 0x301);      // xx- --- 110 x
-                digits[digit++] = _pext_u32(block, 0x70);       // --- xxx 110 -
-                digits[digit++] = _pext_u32(block, 0x80) | 0x8; // --x --- 110 -
-#else
-                digits[digit++] = (block & 0x1) | ((block >> 7) & 0x6);
-                digits[digit++] = (block >> 4) & 0x7;
-                digits[digit++] = 0x8 | ((block >> 7) & 0x1);
-#endif
-                break;
-
-            case 7:
-#ifdef USE_PEXT
-                mode = _pext_u32(block, 0x60); // --- xx- 111 -
-#else
-                mode = (block >> 5) & 0x3;
-#endif
-
-                switch (mode) {
-                    case 0:
-#ifdef USE_PEXT
-                        digits[digit++] = _pext_u32(block, 0x301);      // xx- 00- 111 x
-                        digits[digit++] = _pext_u32(block, 0x10) | 0x8; // --- 00x 111 -
-                        digits[digit++] = _pext_u32(block, 0x80) | 0x8; // --x 00- 111 -
-#else
-                        digits[digit++] = (block & 0x1) | ((block >> 7) & 0x6);
-                        digits[digit++] = 0x8 | ((block >> 4) & 0x1);
-                        digits[digit++] = 0x8 | ((block >> 7) & 0x1);
-#endif
-                        break;
-
-                    case 1:
-#ifdef USE_PEXT
-                        digits[digit++] = _pext_u32(block, 0x1) | 0x8;  // --- 01- 111 x
-                        digits[digit++] = _pext_u32(block, 0x310);      // xx- 01x 111 -
-                        digits[digit++] = _pext_u32(block, 0x80) | 0x8; // --x 01- 111 -
-#else
-                        digits[digit++] = 0x8 | (block & 0x1);
-                        digits[digit++] = ((block >> 4) & 0x1) | ((block >> 7) & 0x6);
-                        digits[digit++] = 0x8 | ((block >> 7) & 0x1);
-#endif
-                        break;
-
-                    case 2:
-#ifdef USE_PEXT
-                        digits[digit++] = _pext_u32(block, 0x1) | 0x8;  // --- 10- 111 x
-                        digits[digit++] = _pext_u32(block, 0x10) | 0x8; // --- 10x 111 -
-                        digits[digit++] = _pext_u32(block, 0x380);      // xxx 10- 111 -
-#else
-                        digits[digit++] = 0x8 | (block & 0x1);
-                        digits[digit++] = 0x8 | ((block >> 4) & 0x1);
-                        digits[digit++] = (block >> 7) & 0x7;
-#endif
-                        break;
-
-                    case 3:
-#ifdef USE_PEXT
-                        digits[digit++] = _pext_u32(block, 0x1) | 0x8;  // --- 11- 111 x
-                        digits[digit++] = _pext_u32(block, 0x10) | 0x8; // --- 11x 111 -
-                        digits[digit++] = _pext_u32(block, 0x80) | 0x8; // --x 11- 111 -
-#else
-                        digits[digit++] = 0x8 | (block & 0x1);
-                        digits[digit++] = 0x8 | ((block >> 4) & 0x1);
-                        digits[digit++] = 0x8 | ((block >> 7) & 0x1);
-#endif
-                        break;
-                }
-                break;
+        if (get_bits(c, nsig + 3, 1) == 0) {
+            put_bits(w, nsig + 3, exp);
+            w[0] |= c[0];
+            w[1] |= c[1];
+        } else {
+            uint64_t low[2];
+            get_low(low, c, nsig + 1);
+
+            put_bits(w, nbits - 3, 3);
+            put_bits(w, nsig + 1, exp);
+            w[0] |= low[0];
+            w[1] |= low[1];
         }
     }
 
-dpd_to_bid:;
-    const size_t payloadwords = BITS_TO_WORDS(nsig + 4) + ((nsig + 4) % 32 != 0);
-    const size_t bufwords = CEILDIV(payloadwords, 2);
-
-    uint32_t *accumulator = (uint32_t *) significand;
-    memset(accumulator, 0, payloadwords * sizeof(uint32_t));
-
-    uint32_t input[bufwords];
-    uint32_t output[bufwords * 2];
-
-    uint32_t x10[bufwords];
-    uint32_t mult[bufwords * 2];
-    uint32_t old_mult[bufwords * 2];
-
-    memset(input, 0, sizeof input);
-    memset(x10, 0, sizeof x10);
-    memset(mult, 0, sizeof mult);
+    goto pack_sign;
 
-    x10[0] = 10;
-    mult[0] = 1;
+pack_dpd:;
+    limb_t tmp[BITS_TO_LIMBS(128)];
+    to_limbs(tmp, BITS_TO_LIMBS(128), c);
 
-    for (size_t i = 0; i < ndigits; ++i) {
-        input[0] = digits[i];
+    for (size_t i = 0; i < nsig / 10; ++i)
+        put_bits(w, 10 * i, __softfp_dpd_encode[divmod_limb(tmp, BITS_TO_LIMBS(128), 1000)]);
 
-        // accumulator += <current digit> * mult
-
-        memcpy(old_mult, mult, sizeof mult);
-        memset(output, 0, sizeof mult);
-
-        __softfp_mul(output, mult, input, bufwords);
-        __softfp_add(accumulator, accumulator, output, payloadwords);
-
-        // mult *= 10
-
-        memset(mult, 0, sizeof mult);
-
-        __softfp_mul(mult, old_mult, x10, bufwords);
-    }
+pack_sign:
+    put_bits(w, nbits - 1, sign);
+    memcpy(data, w, nbits / 8);
 }
 
-void __softfp_dpd_unpack(bool *restrict sign, uint32_t significand[], int32_t *restrict exponent,
+void __softfp_dpd_unpack(bool *restrict sign, limb_t significand[], int32_t *restrict exponent,
                          dclass_t *restrict class, void *restrict data, size_t ncomb, size_t nsig) {
-    unpack(sign, (uint8_t *) significand, exponent, class, (uint8_t *) data, ncomb, nsig, true);
+    unpack(sign, significand, exponent, class, (const uint8_t *) data, ncomb, nsig, true);
 }
 
-void __softfp_bid_unpack(bool *restrict sign, uint32_t significand[], int32_t *restrict exponent,
+void __softfp_bid_unpack(bool *restrict sign, limb_t significand[], int32_t *restrict exponent,
                          dclass_t *restrict class, void *restrict data, size_t ncomb, size_t nsig) {
-    unpack(sign, (uint8_t *) significand, exponent, class, (uint8_t *) data, ncomb, nsig, false);
+    unpack(sign, significand, exponent, class, (const uint8_t *) data, ncomb, nsig, false);
 }
 
-void __softfp_dpd_pack(bool sign, uint32_t significand[], int32_t exponent, dclass_t class, void *restrict data,
+void __softfp_dpd_pack(bool sign, limb_t significand[], int32_t exponent, dclass_t class, void *restrict data,
                        size_t ncomb, size_t nsig) {
-    (void) sign;
-    (void) significand;
-    (void) exponent;
-    (void) class;
-    (void) data;
-    (void) ncomb;
-    (void) nsig;
+    pack(sign, significand, exponent, class, (uint8_t *) data, ncomb, nsig, true);
 }
 
-void __softfp_bid_pack(bool sign, uint32_t significand[], int32_t exponent, dclass_t class, void *restrict data,
+void __softfp_bid_pack(bool sign, limb_t significand[], int32_t exponent, dclass_t class, void *restrict data,
                        size_t ncomb, size_t nsig) {
-    (void) sign;
-    (void) significand;
-    (void) exponent;
-    (void) class;
-    (void) data;
-    (void) ncomb;
-    (void) nsig;
+    pack(sign, significand, exponent, class, (uint8_t *) data, ncomb, nsig, false);
 }
@@ -27,14 +27,14 @@
 #include "../misc/misc.h"
 #include "common.h"
 
-void __softfp_dpd_unpack(bool *restrict sign, uint32_t significand[], int32_t *restrict exponent,
+void __softfp_dpd_unpack(bool *restrict sign, limb_t significand[], int32_t *restrict exponent,
                          dclass_t *restrict class, void *restrict data, size_t ncomb, size_t nsig);
 
-void __softfp_bid_unpack(bool *restrict sign, uint32_t significand[], int32_t *restrict exponent,
+void __softfp_bid_unpack(bool *restrict sign, limb_t significand[], int32_t *restrict exponent,
                          dclass_t *restrict class, void *restrict data, size_t ncomb, size_t nsig);
 
-void __softfp_dpd_pack(bool sign, uint32_t significand[], int32_t exponent, dclass_t class, void *restrict data,
+void __softfp_dpd_pack(bool sign, limb_t significand[], int32_t exponent, dclass_t class, void *restrict data,
                        size_t ncomb, size_t nsig);
 
-void __softfp_bid_pack(bool sign, uint32_t significand[], int32_t exponent, dclass_t class, void *restrict data,
+void __softfp_bid_pack(bool sign, limb_t significand[], int32_t exponent, dclass_t class, void *restrict data,
                        size_t ncomb, size_t nsig);
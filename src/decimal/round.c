@@ -0,0 +1,256 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define SOFTFP_FENV
+#include "softfp.h"
+
+#include "round.h"
+#include "../misc/arith.h"
+#include "../misc/misc.h"
+#include "common.h"
+
+#include <string.h>
+
+#if LIMB_BITS == 64
+#define DIV_MAX_DIGITS 19
+#else
+#define DIV_MAX_DIGITS 9
+#endif
+
+/* the normalized powers of ten `10^k << shift` (1 <= k <= DIV_MAX_DIGITS) and their reciprocals (see divlimb_preinv) */
+static const struct {
+    limb_t d, v;
+    uint8_t shift;
+} reciprocals[DIV_MAX_DIGITS] = {
+#if LIMB_BITS == 64
+    {0xA000000000000000, 0x9999999999999999, 60},
+    {0xC800000000000000, 0x47AE147AE147AE14, 57},
+    {0xFA00000000000000, 0x0624DD2F1A9FBE76, 54},
+    {0x9C40000000000000, 0xA36E2EB1C432CA57, 50},
+    {0xC350000000000000, 0x4F8B588E368F0846, 47},
+    {0xF424000000000000, 0x0C6F7A0B5ED8D36B, 44},
+    {0x9896800000000000, 0xAD7F29ABCAF48578, 40},
+    {0xBEBC200000000000, 0x5798EE2308C39DF9, 37},
+    {0xEE6B280000000000, 0x12E0BE826D694B2E, 34},
+    {0x9502F90000000000, 0xB7CDFD9D7BDBAB7D, 30},
+    {0xBA43B74000000000, 0x5FD7FE17964955FD, 27},
+    {0xE8D4A51000000000, 0x19799812DEA11197, 24},
+    {0x9184E72A00000000, 0xC25C268497681C26, 20},
+    {0xB5E620F480000000, 0x6849B86A12B9B01E, 17},
+    {0xE35FA931A0000000, 0x203AF9EE756159B2, 14},
+    {0x8E1BC9BF04000000, 0xCD2B297D889BC2B6, 10},
+    {0xB1A2BC2EC5000000, 0x70EF54646D496892, 7},
+    {0xDE0B6B3A76400000, 0x2725DD1D243ABA0E, 4},
+    {0x8AC7230489E80000, 0xD83C94FB6D2AC34A, 0},
+#else
+    {0xA0000000, 0x99999999, 28},
+    {0xC8000000, 0x47AE147A, 25},
+    {0xFA000000, 0x0624DD2F, 22},
+    {0x9C400000, 0xA36E2EB1, 18},
+    {0xC3500000, 0x4F8B588E, 15},
+    {0xF4240000, 0x0C6F7A0B, 12},
+    {0x98968000, 0xAD7F29AB, 8},
+    {0xBEBC2000, 0x5798EE23, 5},
+    {0xEE6B2800, 0x12E0BE82, 2},
+#endif
+};
+
+/* compares `a` with `b` (both with `n` limbs) */
+static int compare(const limb_t a[], const limb_t b[], size_t n) {
+    for (size_t i = n; i-- > 0;)
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+
+    return 0;
+}
+
+/* p = 10^k (the result must fit into `n` limbs) */
+static void pow10_limbs(limb_t p[], size_t n, uint32_t k) {
+    uint64_t w[2];
+
+    __softfp_dec_pow128(w, MIN(k, 38));
+    memset(p, 0, n * sizeof(limb_t));
+
+    for (size_t i = 0; i < n && i * LIMB_BITS < 128; ++i)
+        p[i] = (limb_t) (w[i * LIMB_BITS / 64] >> (i * LIMB_BITS % 64));
+
+    if (k > 38)
+        __softfp_dec_scale(p, n, k - 38);
+}
+
+uint32_t __softfp_dec_digits(const limb_t f[], size_t n) {
+    limb_t p[SOFTFP_MUL_MAX_LIMBS];
+    int32_t msb = __softfp_bitscan(f, n, true);
+
+    if (msb < 0)
+        return 0;
+
+    // d = floor((msb + 1) * log10(2)), so f has either d or d + 1 digits (f < 2^(msb+1) and 10^(d-1) < 2^msb)
+    uint32_t d = (uint32_t) (msb + 1) * 315653 >> 20;
+
+    pow10_limbs(p, n, d);
+    return d + (compare(f, p, n) >= 0);
+}
+
+/* calculates `f = f / 10^k` (1 <= k <= DIV_MAX_DIGITS) using the precomputed reciprocal and returns the remainder */
+static limb_t div_pow10(limb_t f[], size_t n, uint32_t k) {
+    limb_t d = reciprocals[k - 1].d;
+    limb_t v = reciprocals[k - 1].v;
+    unsigned shift = reciprocals[k - 1].shift;
+
+    // the dividend is shifted along with the divisor, the remainder is shifted back at the end
+    limb_t r = shift ? f[n - 1] >> (LIMB_BITS - shift) : 0;
+
+    for (size_t i = n; i-- > 0;) {
+        limb_t u = shift ? f[i] << shift | (i ? f[i - 1] >> (LIMB_BITS - shift) : 0) : f[i];
+        f[i] = divlimb_preinv(r, u, d, v, &r);
+    }
+
+    return r >> shift;
+}
+
+/*
+ * calculates `f = f / 10^k` (k >= 1) and returns the rounding bits of the discarded digits (BIT_ROUND for at least
+ * half an ulp, BIT_STICKY for any other nonzero digit)
+ */
+static int drop_digits(limb_t f[], size_t n, uint32_t k) {
+    bool sticky = false;
+
+    // the least significant digits only contribute to the sticky bit
+    for (; k > DIV_MAX_DIGITS; k -= DIV_MAX_DIGITS)
+        sticky |= div_pow10(f, n, DIV_MAX_DIGITS) != 0;
+
+    limb_t rem = div_pow10(f, n, k);
+    limb_t half = (limb_t) (5 * __softfp_pow10[k - 1]);
+
+    if (rem > half)
+        return BIT_ROUND | BIT_STICKY;
+
+    if (rem == half)
+        return BIT_ROUND | (sticky ? BIT_STICKY : 0);
+
+    return rem || sticky ? BIT_STICKY : 0;
+}
+
+uint32_t __softfp_dec_strip(limb_t f[], size_t n, uint32_t max) {
+    limb_t tmp[SOFTFP_MUL_MAX_LIMBS];
+    uint32_t stripped = 0;
+
+    if (n > SOFTFP_MUL_MAX_LIMBS)
+        n = SOFTFP_MUL_MAX_LIMBS;
+
+    for (uint32_t k = 8; k > 0; k >>= 1) {
+        // 10^k can only divide `f` if 2^k does, which rules out most coefficients without a division
+        while (k <= max - stripped && !(f[0] & (((limb_t) 1 << k) - 1))) {
+            memcpy(tmp, f, n * sizeof(limb_t));
+
+            if (div_pow10(tmp, n, k))
+                break;
+
+            memcpy(f, tmp, n * sizeof(limb_t));
+            stripped += k;
+        }
+    }
+
+    return stripped;
+}
+
+int __softfp_dec_round(limb_t f[], size_t n, int32_t *exp, bool sign, int rm, uint32_t prec, int32_t qmin,
+                       int32_t qmax) {
+    if (n > SOFTFP_MUL_MAX_LIMBS)
+        n = SOFTFP_MUL_MAX_LIMBS;
+
+    int64_t e = *exp;
+    int64_t digits = __softfp_dec_digits(f, n);
+    int flags = 0;
+
+    if (digits == 0) { // exact zero, the exponent is clamped
+        *exp = (int32_t) MIN(MAX(e, qmin), qmax);
+        return 0;
+    }
+
+    // tininess is detected before rounding
+    bool tiny = e + digits - 1 < (int64_t) qmin + prec - 1;
+
+    int64_t drop = MAX(digits - (int64_t) prec, qmin - e);
+
+    if (drop > 0) {
+        int round;
+
+        if (drop > digits) { // all digits are discarded, the value is less than half an ulp
+            memset(f, 0, n * sizeof(limb_t));
+            round = BIT_STICKY;
+        } else
+            round = drop_digits(f, n, (uint32_t) drop);
+
+        e += drop;
+
+        if (round) {
+            flags |= SOFTFP_STATUS_INEXACT;
+
+            if (tiny)
+                flags |= SOFTFP_STATUS_UNDERFLOW;
+
+            if (SHOULD_ROUND(sign, round | ((f[0] & 1) ? BIT_GUARD : 0), rm)) {
+                limb_t p[SOFTFP_MUL_MAX_LIMBS];
+
+                __softfp_arr_inc(f, n);
+                pow10_limbs(p, n, prec);
+
+                if (compare(f, p, n) == 0) { // carry into the next decade
+                    pow10_limbs(f, n, prec - 1);
+                    ++e;
+                }
+            }
+        }
+    }
+
+    if (e > qmax) {
+        digits = __softfp_dec_digits(f, n);
+
+        if (digits == 0 || digits + (e - qmax) <= prec) { // the coefficient can be padded with zeros
+            if (digits)
+                __softfp_dec_scale(f, n, (uint32_t) (e - qmax));
+
+            e = qmax;
+        } else { // overflow
+            flags |= SOFTFP_STATUS_OVERFLOW | SOFTFP_STATUS_INEXACT;
+
+            memset(f, 0, n * sizeof(limb_t));
+
+            if (rm == FE_TONEAREST || (rm == FE_UPWARD && !sign) || (rm == FE_DOWNWARD && sign))
+                e = DEXP_INF;
+            else { // largest finite value: 10^prec - 1
+                pow10_limbs(f, n, prec);
+
+                for (size_t i = 0; f[i]-- == 0; ++i) // decrement with borrow
+                    ;
+
+                e = qmax;
+            }
+        }
+    }
+
+    *exp = (int32_t) e;
+    return flags;
+}
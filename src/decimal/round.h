@@ -0,0 +1,51 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "../lsp.h"
+#include "../misc/misc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * rounds the value `f * 10^exp` to at most `prec` digits according to the rounding mode `rm`, so that the exponent is
+ * between `qmin` and `qmax`. Tiny results lose digits (or are rounded to zero), results with an exponent above `qmax`
+ * are padded with zeros, if possible. Overflows produce either infinity (`exp = DEXP_INF`, `f = 0`) or the largest
+ * finite value, depending on `rm`.
+ *
+ * @param f[n] coefficient (binary integer)
+ * @param exp exponent
+ * @param sign sign of the value
+ * @param rm rounding mode
+ * @return the raised exceptions (`SOFTFP_STATUS_INEXACT`, `SOFTFP_STATUS_OVERFLOW` and/or `SOFTFP_STATUS_UNDERFLOW`)
+ */
+int __softfp_dec_round(limb_t f[], size_t n, int32_t *exp, bool sign, int rm, uint32_t prec, int32_t qmin,
+                       int32_t qmax);
+
+/* the number of decimal digits of `f[n]` (0 if `f` is zero) */
+uint32_t __softfp_dec_digits(const limb_t f[], size_t n);
+
+/* removes up to `max` trailing zero digits from the nonzero coefficient `f[n]` and returns their number */
+uint32_t __softfp_dec_strip(limb_t f[], size_t n, uint32_t max);
@@ -0,0 +1,236 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* order-preserving keys of decimal floating-point numbers (see ../sort.h) */
+
+#include "../lsp.h"
+#include "../misc/arith.h"
+#include "declet.h"
+
+#include <string.h>
+
+#define fsortkey __FPFUN_STATIC(sortkey)
+
+/*
+ * Members of a cohort (e.g. 1.0 and 1.00) have the same value, so the key is derived from the canonical form of the
+ * number instead of its encoding: the coefficient `c` (with `k` digits) is scaled to the full precision `p` and the
+ * biased exponent `e` is adjusted accordingly. Then, the magnitude of a finite number is
+ *
+ *   K = 0                                 if c == 0
+ *   K = (e + k - 1) * 10^p + c * 10^(p-k) otherwise
+ *
+ * which increases monotonically with the value, since `e + k - 1` is the (biased) exponent of the most significant
+ * digit. Infinity is placed right after the largest finite number, followed by the signaling and then the quiet NaNs
+ * (each ordered by their payload). Finally, the key is `K | 2^(bits-1)` for positive numbers and `2^(bits-1) - 1 - K`
+ * for negative ones, which matches the ordering of IEEE 754 totalOrder, except that the members of a cohort are
+ * equal. Since the sort is stable, they keep their relative order. Non-canonical coefficients and payloads are treated
+ * as zero.
+ */
+
+#if FBITS <= 64
+
+#define DKEY_INF ((uint64_t) (DEXPMAX - 1 + DPREC) * __softfp_pow10[DPREC])
+#define DKEY_SIGN ((uint64_t) 1 << (FBITS - 1))
+
+/* the value of the declets in `x` */
+static inline uint64_t __FPFUN_STATIC(sortkey_declets)(uint64_t x) {
+    uint64_t c = 0;
+
+    for (int i = FSIGN / 10 - 1; i >= 0; --i)
+        c = c * 1000 + __softfp_dpd_decode[(x >> (10 * i)) & 0x3FF];
+
+    return c;
+}
+
+static void fsortkey(void *key, const void *elem) {
+    uint64_t x = 0;
+    memcpy(&x, elem, FBITS / 8);
+
+    unsigned comb = (x >> (FBITS - 6)) & 0x1F; // the first five bits of the combination field
+    uint64_t e, c, k;
+
+    if (comb == 0x1F) { // NaN
+        c = FDPD ? __FPFUN_STATIC(sortkey_declets)(x) : x & (((uint64_t) 1 << FSIGN) - 1);
+
+        if (c >= __softfp_pow10[DPREC - 1])
+            c = 0;
+
+        k = DKEY_INF + 1 + c;
+
+        if (!((x >> (FBITS - 7)) & 1)) // quiet
+            k += __softfp_pow10[DPREC - 1];
+    } else if (comb == 0x1E) // infinity
+        k = DKEY_INF;
+    else {
+        if (FDPD) {
+            unsigned expmsb;
+            unsigned lead = __softfp_dpd_lead(comb, &expmsb);
+
+            e = (uint64_t) expmsb << (FCOMB - 5) | ((x >> FSIGN) & ((1 << (FCOMB - 5)) - 1));
+            c = lead * __softfp_pow10[DPREC - 1] + __FPFUN_STATIC(sortkey_declets)(x);
+        } else if ((comb >> 3) != 3) {
+            e = (x >> (FSIGN + 3)) & ((1 << (FCOMB - 3)) - 1);
+            c = x & (((uint64_t) 1 << (FSIGN + 3)) - 1);
+        } else {
+            e = (x >> (FSIGN + 1)) & ((1 << (FCOMB - 3)) - 1);
+            c = ((uint64_t) 1 << (FSIGN + 3)) | (x & (((uint64_t) 1 << (FSIGN + 1)) - 1));
+        }
+
+        if (c == 0 || c >= __softfp_pow10[DPREC])
+            k = 0;
+        else {
+            unsigned digits = DPREC;
+
+            while (c < __softfp_pow10[digits - 1])
+                --digits;
+
+            k = (e + digits - 1) * __softfp_pow10[DPREC] + c * __softfp_pow10[DPREC - digits];
+        }
+    }
+
+    k = (x & DKEY_SIGN) ? ~k & (DKEY_SIGN - 1) : k | DKEY_SIGN;
+    memcpy(key, &k, FBITS / 8);
+}
+
+#undef DKEY_INF
+#undef DKEY_SIGN
+
+#elif FBITS == 128
+
+#define DKEY_P ((const uint64_t[2]) {UINT64_C(0x378D8E6400000000), UINT64_C(0x1ED09BEAD87C0)}) // 10^34
+#define DKEY_INF(r) __softfp_dec_mul128(r, DKEY_P, DEXPMAX - 1 + DPREC)
+
+_Static_assert(DPREC == 34, "unsupported precision");
+
+/* the value of the declets in `x` */
+static inline void __FPFUN_STATIC(sortkey_declets)(uint64_t r[2], const uint64_t x[2], uint64_t lead) {
+    uint64_t mid = (x[0] >> 60) | (x[1] << 4); // the declets 6 to 10 (declet 6 spans both words)
+    uint64_t lo = 0, hi = lead;
+
+    for (int i = 4; i >= 0; --i)
+        hi = hi * 1000 + __softfp_dpd_decode[(mid >> (10 * i)) & 0x3FF];
+
+    for (int i = 5; i >= 0; --i)
+        lo = lo * 1000 + __softfp_dpd_decode[(x[0] >> (10 * i)) & 0x3FF];
+
+    muladd64(r, hi, __softfp_pow10[18], lo);
+}
+
+static void fsortkey(void *key, const void *elem) {
+    uint64_t x[2];
+    memcpy(x, elem, sizeof x);
+
+    unsigned comb = (x[1] >> 58) & 0x1F; // the first five bits of the combination field
+    uint64_t c[2], k[2], p[2];
+    uint64_t e;
+
+    if (comb == 0x1F) { // NaN
+        if (FDPD)
+            __FPFUN_STATIC(sortkey_declets)(c, x, 0);
+        else {
+            c[0] = x[0];
+            c[1] = x[1] & (((uint64_t) 1 << (FSIGN - 64)) - 1);
+        }
+
+        __softfp_dec_pow128(p, DPREC - 1);
+
+        if (!__softfp_dec_less128(c, p))
+            c[0] = c[1] = 0;
+
+        if (!((x[1] >> 57) & 1)) { // quiet
+            c[0] += p[0];
+            c[1] += p[1] + (c[0] < p[0]);
+        }
+
+        DKEY_INF(k);
+        ++c[0];
+        c[1] += c[0] == 0;
+
+        k[0] += c[0];
+        k[1] += c[1] + (k[0] < c[0]);
+    } else if (comb == 0x1E) // infinity
+        DKEY_INF(k);
+    else {
+        if (FDPD) {
+            unsigned expmsb;
+            unsigned lead = __softfp_dpd_lead(comb, &expmsb);
+
+            e = (uint64_t) expmsb << (FCOMB - 5) | ((x[1] >> (FSIGN - 64)) & ((1 << (FCOMB - 5)) - 1));
+            __FPFUN_STATIC(sortkey_declets)(c, x, lead);
+        } else if ((comb >> 3) != 3) {
+            e = (x[1] >> (FSIGN + 3 - 64)) & ((1 << (FCOMB - 3)) - 1);
+            c[0] = x[0];
+            c[1] = x[1] & (((uint64_t) 1 << (FSIGN + 3 - 64)) - 1);
+        } else { // the coefficient is at least 2^113, which is non-canonical
+            e = 0;
+            c[0] = c[1] = 0;
+        }
+
+        __softfp_dec_pow128(p, DPREC);
+
+        if ((c[0] | c[1]) == 0 || !__softfp_dec_less128(c, p))
+            k[0] = k[1] = 0;
+        else {
+            unsigned digits = DPREC;
+
+            for (;;) {
+                __softfp_dec_pow128(p, digits - 1);
+
+                if (!__softfp_dec_less128(c, p))
+                    break;
+
+                --digits;
+            }
+
+            /* c * 10^(DPREC-digits), in two steps, since 10^33 does not fit into 64 bits */
+            unsigned scale = DPREC - digits;
+
+            if (scale > 19) {
+                __softfp_dec_mul128(c, c, __softfp_pow10[19]);
+                scale -= 19;
+            }
+
+            __softfp_dec_mul128(c, c, __softfp_pow10[scale]);
+
+            __softfp_dec_mul128(k, DKEY_P, e + digits - 1);
+
+            k[0] += c[0];
+            k[1] += c[1] + (k[0] < c[0]);
+        }
+    }
+
+    if (x[1] >> 63) {
+        k[0] = ~k[0];
+        k[1] = ~k[1] & ~((uint64_t) 1 << 63);
+    } else
+        k[1] |= (uint64_t) 1 << 63;
+
+    memcpy(key, k, sizeof k);
+}
+
+#undef DKEY_P
+#undef DKEY_INF
+
+#else
+#error "unsupported decimal format"
+#endif
@@ -0,0 +1,295 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* bulk conversion of decimal64 and decimal128 values from DPD to BID */
+
+#define SOFTFP_FENV
+#include "softfp.h"
+
+#include "../misc/arith.h"
+#include "../misc/cpu.h"
+#include "../misc/misc.h"
+#include "declet.h"
+
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*
+ * Both encodings consist of the sign bit, the combination field and the trailing significand. The first five bits of
+ * the combination field (`comb`) determine the class, the two most significant bits of the exponent and (for DPD) the
+ * leading digit of the coefficient:
+ *
+ *   comb = 0b11111  NaN (the next bit is set for signaling NaNs)
+ *   comb = 0b11110  infinity
+ *   comb = 0b11EEL  finite, exponent = EE..., leading digit = 8 + L
+ *   comb = 0bEELLL  finite, exponent = EE..., leading digit = LLL
+ *
+ * The remaining bits of the DPD combination field continue the exponent, the trailing significand holds the other
+ * digits as declets. In BID, the exponent directly follows the sign bit (or the bits `11`, if the coefficient doesn't
+ * fit into the trailing significand), and the coefficient is stored as a binary integer. NaNs keep their payload and
+ * infinities are canonicalized.
+ */
+
+#define COMB_SHIFT 58
+#define COMB_INF 0x1E
+#define COMB_NAN 0x1F
+#define SIGN_BIT ((uint64_t) 1 << 63)
+#define SNAN_BIT ((uint64_t) 1 << 57)
+#define BITS_INF ((uint64_t) 0x78 << 56)
+#define BITS_NAN ((uint64_t) 0x7C << 56)
+
+/* decimal64: 8 exponent continuation bits, 5 declets, coefficients < 2^53 are stored in the trailing significand */
+#define DEC64_EXPCONT 8
+#define DEC64_LARGE ((uint64_t) 1 << 53)
+
+/* decimal128: 12 exponent continuation bits, 11 declets, the coefficient always fits into the trailing significand */
+#define DEC128_EXPCONT 12
+
+/* the value of the `i`-th declet in the lower 64 bits of the trailing significand */
+static inline uint64_t declet(uint64_t x, unsigned int i) {
+    return __softfp_dpd_decode[(x >> (10 * i)) & 0x3FF];
+}
+
+/* the two most significant bits of the exponent and the leading digit of the coefficient of a finite value */
+static inline void decode_comb(uint32_t comb, uint32_t *exp, uint32_t *lead) {
+    if ((comb & 0x18) == 0x18) {
+        *exp = (comb >> 1) & 0x3;
+        *lead = 0x8 | (comb & 0x1);
+    } else {
+        *exp = comb >> 3;
+        *lead = comb & 0x7;
+    }
+}
+
+/* `x` is the DPD encoding, `coeff` is the coefficient without the leading digit (i.e., the trailing significand) */
+static inline uint64_t pack_bid64(uint64_t x, uint64_t coeff) {
+    uint64_t sign = x & SIGN_BIT;
+    uint32_t comb = (x >> COMB_SHIFT) & 0x1F;
+
+    if (comb == COMB_INF)
+        return sign | BITS_INF;
+
+    if (comb == COMB_NAN)
+        return sign | BITS_NAN | (x & SNAN_BIT) | coeff;
+
+    uint32_t expmsb, lead;
+    decode_comb(comb, &expmsb, &lead);
+
+    uint64_t exp = (uint64_t) expmsb << DEC64_EXPCONT | ((x >> 50) & 0xFF);
+    coeff += lead * UINT64_C(1000000000000000);
+
+    if (coeff < DEC64_LARGE)
+        return sign | exp << 53 | coeff;
+
+    return sign | (uint64_t) 0x3 << 61 | exp << 51 | (coeff & (DEC64_LARGE / 4 - 1));
+}
+
+static inline uint64_t dpd_to_bid64(uint64_t x) {
+    uint64_t lo = declet(x, 0) + declet(x, 1) * 1000 + declet(x, 2) * 1000000;
+    uint64_t hi = declet(x, 3) + declet(x, 4) * 1000;
+
+    return pack_bid64(x, hi * 1000000000 + lo);
+}
+
+/*
+ * `x` is the DPD encoding (least significant word first), the coefficient without the leading digit is
+ * `hi * 10^18 + lo`, where `hi` holds the declets 6 to 10 and `lo` the declets 0 to 5
+ */
+static inline void pack_bid128(uint64_t r[2], const uint64_t x[2], uint64_t hi, uint64_t lo) {
+    uint64_t sign = x[1] & SIGN_BIT;
+    uint32_t comb = (x[1] >> COMB_SHIFT) & 0x1F;
+
+    if (comb == COMB_INF) {
+        r[0] = 0;
+        r[1] = sign | BITS_INF;
+        return;
+    }
+
+    uint64_t coeff[2];
+
+    if (comb == COMB_NAN) {
+        muladd64(coeff, hi, UINT64_C(1000000000000000000), lo);
+
+        r[0] = coeff[0];
+        r[1] = sign | BITS_NAN | (x[1] & SNAN_BIT) | coeff[1];
+        return;
+    }
+
+    uint32_t expmsb, lead;
+    decode_comb(comb, &expmsb, &lead);
+
+    uint64_t exp = (uint64_t) expmsb << DEC128_EXPCONT | ((x[1] >> 46) & 0xFFF);
+
+    muladd64(coeff, hi + lead * UINT64_C(1000000000000000), UINT64_C(1000000000000000000), lo);
+
+    r[0] = coeff[0];
+    r[1] = sign | exp << 49 | coeff[1];
+}
+
+static inline void dpd_to_bid128(uint64_t r[2], const uint64_t x[2]) {
+    uint64_t mid = (x[0] >> 60) | (x[1] << 4); // the declets 6 to 10 (declet 6 spans both words)
+
+    uint64_t lo = declet(x[0], 0) + declet(x[0], 1) * 1000 + declet(x[0], 2) * 1000000 +
+                  (declet(x[0], 3) + declet(x[0], 4) * 1000 + declet(x[0], 5) * 1000000) * 1000000000;
+
+    uint64_t hi = declet(mid, 0) + declet(mid, 1) * 1000 + declet(mid, 2) * 1000000 +
+                  (declet(mid, 3) + declet(mid, 4) * 1000) * 1000000000;
+
+    pack_bid128(r, x, hi, lo);
+}
+
+#ifdef __AVX2__
+/* loads the declets at bit offset `shift` of each lane and decodes them */
+static inline __m256i declet_lanes(__m256i x, int shift) {
+    __m256i idx = _mm256_and_si256(_mm256_srlv_epi64(x, _mm256_set1_epi64x(shift)), _mm256_set1_epi64x(0x3FF));
+    __m128i val = _mm256_i64gather_epi32((const int *) __softfp_dpd_decode, idx, 2);
+
+    return _mm256_and_si256(_mm256_cvtepu32_epi64(val), _mm256_set1_epi64x(0xFFFF));
+}
+
+/* calculates `a + b * m + c * m^2` for m = 1000 (all values < 2^32) */
+static inline __m256i combine3(__m256i a, __m256i b, __m256i c) {
+    __m256i m = _mm256_set1_epi64x(1000);
+    __m256i m2 = _mm256_set1_epi64x(1000000);
+
+    return _mm256_add_epi64(a, _mm256_add_epi64(_mm256_mul_epu32(b, m), _mm256_mul_epu32(c, m2)));
+}
+
+/* converts four decimal64 values, the encoding is done as in pack_bid64 */
+static inline __m256i dpd_to_bid64_lanes(__m256i x) {
+    const __m256i mask5 = _mm256_set1_epi64x(0x1F);
+
+    __m256i lo = combine3(declet_lanes(x, 0), declet_lanes(x, 10), declet_lanes(x, 20));
+    __m256i hi = combine3(declet_lanes(x, 30), declet_lanes(x, 40), _mm256_setzero_si256());
+
+    __m256i sign = _mm256_and_si256(x, _mm256_set1_epi64x((int64_t) SIGN_BIT));
+    __m256i comb = _mm256_and_si256(_mm256_srli_epi64(x, COMB_SHIFT), mask5);
+
+    __m256i inf = _mm256_cmpeq_epi64(comb, _mm256_set1_epi64x(COMB_INF));
+    __m256i nan = _mm256_cmpeq_epi64(comb, _mm256_set1_epi64x(COMB_NAN));
+    __m256i large = _mm256_cmpeq_epi64(_mm256_and_si256(comb, _mm256_set1_epi64x(0x18)), _mm256_set1_epi64x(0x18));
+
+    __m256i expmsb = _mm256_blendv_epi8(_mm256_srli_epi64(comb, 3),
+                                        _mm256_and_si256(_mm256_srli_epi64(comb, 1), _mm256_set1_epi64x(0x3)), large);
+    __m256i lead = _mm256_blendv_epi8(_mm256_and_si256(comb, _mm256_set1_epi64x(0x7)),
+                                      _mm256_or_si256(_mm256_and_si256(comb, _mm256_set1_epi64x(0x1)),
+                                                      _mm256_set1_epi64x(0x8)),
+                                      large);
+
+    lead = _mm256_andnot_si256(_mm256_or_si256(inf, nan), lead);
+    hi = _mm256_add_epi64(hi, _mm256_mul_epu32(lead, _mm256_set1_epi64x(1000000)));
+
+    __m256i coeff = _mm256_add_epi64(lo, _mm256_mul_epu32(hi, _mm256_set1_epi64x(1000000000)));
+
+    __m256i exp = _mm256_or_si256(_mm256_slli_epi64(expmsb, DEC64_EXPCONT),
+                                  _mm256_and_si256(_mm256_srli_epi64(x, 50), _mm256_set1_epi64x(0xFF)));
+
+    __m256i small = _mm256_cmpgt_epi64(_mm256_set1_epi64x(DEC64_LARGE), coeff);
+
+    __m256i rsmall = _mm256_or_si256(_mm256_slli_epi64(exp, 53), coeff);
+    __m256i rlarge = _mm256_or_si256(_mm256_set1_epi64x((int64_t) 0x3 << 61), _mm256_slli_epi64(exp, 51));
+    rlarge = _mm256_or_si256(rlarge, _mm256_and_si256(coeff, _mm256_set1_epi64x(DEC64_LARGE / 4 - 1)));
+
+    __m256i r = _mm256_blendv_epi8(rlarge, rsmall, small);
+
+    __m256i rnan = _mm256_or_si256(_mm256_set1_epi64x((int64_t) BITS_NAN),
+                                   _mm256_or_si256(_mm256_and_si256(x, _mm256_set1_epi64x((int64_t) SNAN_BIT)), coeff));
+
+    r = _mm256_blendv_epi8(r, _mm256_set1_epi64x((int64_t) BITS_INF), inf);
+    r = _mm256_blendv_epi8(r, rnan, nan);
+
+    return _mm256_or_si256(r, sign);
+}
+#endif
+
+KERNEL_LINKAGE void KERNEL(__softfp_dpd_to_bid64)(void *dst, const void *src, size_t n) {
+    uint8_t *out = dst;
+    const uint8_t *in = src;
+    size_t i = 0;
+
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *) &in[8 * i]);
+        _mm256_storeu_si256((__m256i *) &out[8 * i], dpd_to_bid64_lanes(x));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        uint64_t x;
+        memcpy(&x, &in[8 * i], sizeof x);
+        x = dpd_to_bid64(x);
+        memcpy(&out[8 * i], &x, sizeof x);
+    }
+}
+
+KERNEL_LINKAGE void KERNEL(__softfp_dpd_to_bid128)(void *dst, const void *src, size_t n) {
+    uint8_t *out = dst;
+    const uint8_t *in = src;
+    size_t i = 0;
+
+#ifdef __AVX2__
+    /* the declets are decoded in parallel, the coefficients are assembled per value (they don't fit into a lane) */
+    for (; i + 4 <= n; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i *) &in[16 * i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *) &in[16 * i + 32]);
+
+        // separate the lower and upper words of the four values
+        __m256i xlo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        __m256i xhi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        __m256i xmid = _mm256_or_si256(_mm256_srli_epi64(xlo, 60), _mm256_slli_epi64(xhi, 4));
+
+        __m256i billion = _mm256_set1_epi64x(1000000000);
+
+        __m256i lo0 = combine3(declet_lanes(xlo, 0), declet_lanes(xlo, 10), declet_lanes(xlo, 20));
+        __m256i lo1 = combine3(declet_lanes(xlo, 30), declet_lanes(xlo, 40), declet_lanes(xlo, 50));
+        __m256i hi0 = combine3(declet_lanes(xmid, 0), declet_lanes(xmid, 10), declet_lanes(xmid, 20));
+        __m256i hi1 = combine3(declet_lanes(xmid, 30), declet_lanes(xmid, 40), _mm256_setzero_si256());
+
+        uint64_t lo[4], hi[4];
+        _mm256_storeu_si256((__m256i *) lo, _mm256_add_epi64(lo0, _mm256_mul_epu32(lo1, billion)));
+        _mm256_storeu_si256((__m256i *) hi, _mm256_add_epi64(hi0, _mm256_mul_epu32(hi1, billion)));
+
+        for (size_t j = 0; j < 4; ++j) {
+            uint64_t x[2], r[2];
+            memcpy(x, &in[16 * (i + j)], sizeof x);
+            pack_bid128(r, x, hi[j], lo[j]);
+            memcpy(&out[16 * (i + j)], r, sizeof r);
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        uint64_t x[2], r[2];
+        memcpy(x, &in[16 * i], sizeof x);
+        dpd_to_bid128(r, x);
+        memcpy(&out[16 * i], r, sizeof r);
+    }
+}
+
+#if defined SOFTFP_DISPATCH && !defined SOFTFP_VARIANT
+KERNEL_DISPATCH_AVX2(void, __softfp_dpd_to_bid64, (void *dst, const void *src, size_t n));
+KERNEL_DISPATCH_AVX2(void, __softfp_dpd_to_bid128, (void *dst, const void *src, size_t n));
+#endif
@@ -23,37 +23,12 @@
 
 #include "arith.h"
 
+#include "cpu.h"
 #include "misc.h"
 
-#ifdef X86
-#include <immintrin.h>
-#endif
-
-static inline uint32_t addcarry(uint32_t a, uint32_t b, uint8_t *carry) {
-    uint32_t c;
-#ifdef X86
-    *carry = _addcarry_u32(*carry, a, b, &c);
-#else
-    c = a + b + *carry;
-
-    *carry = (c <= a && c <= b) ? 1 : 0; // overflow check
-#endif
-    return c;
-}
-
-static inline uint32_t subborrow(uint32_t a, uint32_t b, uint8_t *carry) {
-    uint32_t c;
-#ifdef X86
-    *carry = _subborrow_u32(*carry, a, b, &c);
-#else
-    c = a - b - *carry;
+#include <string.h>
 
-    *carry = ((b == UINT32_MAX && *carry) || b + *carry > a) ? 1 : 0; // overflow check
-#endif
-    return c;
-}
-
-int __softfp_add(uint32_t r[], const uint32_t a[], const uint32_t b[], size_t n) {
+KERNEL_LINKAGE int KERNEL(__softfp_add)(limb_t r[], const limb_t a[], const limb_t b[], size_t n) {
     uint8_t carry = 0;
 
     for (size_t i = 0; i < n; ++i)
@@ -62,34 +37,153 @@ int __softfp_add(uint32_t r[], const uint32_t a[], const uint32_t b[], size_t n)
     return carry;
 }
 
-int __softfp_sub(uint32_t r[], const uint32_t a[], const uint32_t b[], size_t n) {
-    uint8_t carry = 1;
+KERNEL_LINKAGE int KERNEL(__softfp_sub)(limb_t r[], const limb_t a[], const limb_t b[], size_t n) {
+    uint8_t borrow = 0;
 
     for (size_t i = 0; i < n; ++i)
-        r[i] = subborrow(a[i], b[i], &carry);
+        r[i] = subborrow(a[i], b[i], &borrow);
 
-    if (!carry)
+    if (!borrow)
         return 0;
 
+    // negate the result (two's complement)
+    borrow = 0;
+
     for (size_t i = 0; i < n; ++i)
-        r[i] = ~subborrow(r[i], 0, &carry);
+        r[i] = subborrow(0, r[i], &borrow);
 
     return 1;
 }
 
-int __softfp_mul(uint32_t r[], uint32_t a[], const uint32_t b[], size_t n) {
+KERNEL_LINKAGE void KERNEL(__softfp_acc_add)(limb_t acc[], size_t n, const limb_t a[], size_t m, size_t shift,
+                                             bool sub) {
+    const size_t wordshift = shift / LIMB_BITS;
+    const size_t bitshift = shift % LIMB_BITS;
+
+    uint8_t carry = 0;
+    limb_t prev = 0;
+    size_t i = wordshift;
+
+    for (size_t j = 0; j <= m && i < n; ++i, ++j) {
+        limb_t cur = j < m ? a[j] : 0;
+        limb_t w = bitshift ? (cur << bitshift) | (prev >> (LIMB_BITS - bitshift)) : cur;
+
+        acc[i] = sub ? subborrow(acc[i], w, &carry) : addcarry(acc[i], w, &carry);
+        prev = cur;
+    }
+
+    // the carry (or borrow) usually stops after a few limbs
+    for (; carry && i < n; ++i)
+        acc[i] = sub ? subborrow(acc[i], 0, &carry) : addcarry(acc[i], 0, &carry);
+}
+
+/* (c2:c1:c0) += a * b */
+static inline void muladd(limb_t a, limb_t b, limb_t *c0, limb_t *c1, limb_t *c2) {
+    limb_t hi, lo = mullimb(a, b, &hi);
     uint8_t carry = 0;
 
-    for (size_t i = 0, shift = 0; i < 32 * n; ++i, ++shift)
-        if (b[BITS_TO_WORDS(i + 1) - 1] & (1 << (i % 32))) {
-            __softfp_arr_shift(a, 2 * n, shift);
+    *c0 = addcarry(*c0, lo, &carry);
+    *c1 = addcarry(*c1, hi, &carry);
+    *c2 += carry;
+}
+
+/* adds the k-th column of the product `a * b` to the accumulator (Comba) */
+static inline void column(const limb_t a[], const limb_t b[], size_t n, size_t k, limb_t *c0, limb_t *c1,
+                          limb_t *c2) {
+    size_t lo = k < n ? 0 : k - n + 1;
+    size_t hi = k < n ? k : n - 1;
 
-            carry = 0;
-            shift = 0;
+    for (size_t i = lo; i <= hi; ++i)
+        muladd(a[i], b[k - i], c0, c1, c2);
+}
 
-            for (size_t j = 0; j < 2 * n; ++j)
-                r[j] = addcarry(r[j], a[j], &carry);
-        }
+static void mul_comba(limb_t r[], const limb_t a[], const limb_t b[], size_t n) {
+    limb_t c0 = 0, c1 = 0, c2 = 0;
 
-    return carry;
+    for (size_t k = 0; k < 2 * n - 1; ++k) {
+        column(a, b, n, k, &c0, &c1, &c2);
+
+        r[k] = c0;
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+
+    r[2 * n - 1] = c0;
+}
+
+/* operands have at most a few limbs here, so Karatsuba's method would be slower than the schoolbook product */
+KERNEL_LINKAGE void KERNEL(__softfp_mul)(limb_t r[], const limb_t a[], const limb_t b[], size_t n) {
+    if (n)
+        mul_comba(r, a, b, n);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_mul_shr)(limb_t r[], const limb_t a[], const limb_t b[], size_t n, size_t shift) {
+    if (!n)
+        return 0;
+
+    const size_t wordshift = shift / LIMB_BITS;
+    const size_t bitshift = shift % LIMB_BITS;
+
+    limb_t c0 = 0, c1 = 0, c2 = 0;
+    limb_t below = 0; // the limb directly below the kept window
+    bool sticky = false;
+
+    // the lower limbs only contribute to the sticky bit
+
+    for (size_t k = 0; k < wordshift && k < 2 * n; ++k) {
+        column(a, b, n, k, &c0, &c1, &c2);
+
+        sticky |= below != 0;
+        below = c0;
+
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+
+    // keep n + 1 limbs, so the window can be shifted by `bitshift` afterwards
+
+    limb_t window[SOFTFP_MUL_MAX_LIMBS + 1];
+
+    for (size_t i = 0; i <= n; ++i) {
+        size_t k = wordshift + i;
+
+        if (k < 2 * n)
+            column(a, b, n, k, &c0, &c1, &c2);
+
+        window[i] = k < 2 * n ? c0 : 0;
+
+        c0 = c1;
+        c1 = c2;
+        c2 = 0;
+    }
+
+    bool round;
+
+    if (bitshift) {
+        limb_t mask = ((limb_t) 1 << (bitshift - 1)) - 1;
+
+        round = (window[0] >> (bitshift - 1)) & 1;
+        sticky |= below != 0 || (window[0] & mask) != 0;
+
+        for (size_t i = 0; i < n; ++i)
+            r[i] = (window[i] >> bitshift) | (window[i + 1] << (LIMB_BITS - bitshift));
+    } else {
+        round = wordshift && (below >> (LIMB_BITS - 1)) & 1;
+        sticky |= (below & (~(limb_t) 0 >> 1)) != 0;
+
+        memcpy(r, window, n * sizeof(limb_t));
+    }
+
+    return (sticky ? BIT_STICKY : 0) | (round ? BIT_ROUND : 0) | ((r[0] & 1) ? BIT_GUARD : 0);
 }
+
+#if defined SOFTFP_DISPATCH && !defined SOFTFP_VARIANT
+KERNEL_DISPATCH_BMI2(int, __softfp_add, (limb_t r[], const limb_t a[], const limb_t b[], size_t n));
+KERNEL_DISPATCH_BMI2(int, __softfp_sub, (limb_t r[], const limb_t a[], const limb_t b[], size_t n));
+KERNEL_DISPATCH_BMI2(void, __softfp_acc_add,
+                     (limb_t acc[], size_t n, const limb_t a[], size_t m, size_t shift, bool sub));
+KERNEL_DISPATCH_BMI2(void, __softfp_mul, (limb_t r[], const limb_t a[], const limb_t b[], size_t n));
+KERNEL_DISPATCH_BMI2(int, __softfp_mul_shr, (limb_t r[], const limb_t a[], const limb_t b[], size_t n, size_t shift));
+#endif
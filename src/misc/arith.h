@@ -23,34 +23,241 @@
 
 #pragma once
 
+#include "misc.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#ifdef X86
+#include <immintrin.h>
+#endif
+
+/* r = a + b + carry; sets carry to the carry out */
+static inline limb_t addcarry(limb_t a, limb_t b, uint8_t *carry) {
+#if defined X86_64 && LIMB_BITS == 64
+    unsigned long long c;
+    *carry = _addcarry_u64(*carry, a, b, &c);
+    return c;
+#elif defined X86 && LIMB_BITS == 32
+    unsigned int c;
+    *carry = _addcarry_u32(*carry, a, b, &c);
+    return c;
+#else
+    dlimb_t c = (dlimb_t) a + b + *carry;
+    *carry = c >> LIMB_BITS;
+    return c;
+#endif
+}
+
+/* r = a - b - borrow; sets borrow to the borrow out */
+static inline limb_t subborrow(limb_t a, limb_t b, uint8_t *borrow) {
+#if defined X86_64 && LIMB_BITS == 64
+    unsigned long long c;
+    *borrow = _subborrow_u64(*borrow, a, b, &c);
+    return c;
+#elif defined X86 && LIMB_BITS == 32
+    unsigned int c;
+    *borrow = _subborrow_u32(*borrow, a, b, &c);
+    return c;
+#else
+    dlimb_t c = (dlimb_t) a - b - *borrow;
+    *borrow = (c >> LIMB_BITS) & 1;
+    return c;
+#endif
+}
+
+/* returns the lower half of `a * b` and stores the upper half in `hi` */
+static inline limb_t mullimb(limb_t a, limb_t b, limb_t *hi) {
+#if defined X86_64 && LIMB_BITS == 64 && defined __BMI2__ /* `mulx` does not clobber the flags */
+    unsigned long long h;
+    limb_t lo = _mulx_u64(a, b, &h);
+    *hi = h;
+    return lo;
+#else
+    dlimb_t c = (dlimb_t) a * b;
+    *hi = c >> LIMB_BITS;
+    return c;
+#endif
+}
+
+/* returns `(hi:lo) / d` and stores the remainder in `rem` (requires `hi < d`) */
+static inline limb_t divlimb(limb_t hi, limb_t lo, limb_t d, limb_t *rem) {
+#if defined X86_64 && LIMB_BITS == 64 && defined __GNUC__
+    limb_t q, r;
+    __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "rm"(d));
+    *rem = r;
+    return q;
+#else
+    dlimb_t n = ((dlimb_t) hi << LIMB_BITS) | lo;
+    *rem = n % d;
+    return n / d;
+#endif
+}
+
+/*
+ * returns `(hi:lo) / d` and stores the remainder in `rem` (requires `hi < d`), where `d` is normalized (its most
+ * significant bit is set) and `v = floor((2^(2*LIMB_BITS) - 1) / d) - 2^LIMB_BITS` is its precomputed reciprocal (see
+ * Möller and Granlund, "Improved division by invariant integers")
+ */
+static inline limb_t divlimb_preinv(limb_t hi, limb_t lo, limb_t d, limb_t v, limb_t *rem) {
+    limb_t qh, ql = mullimb(v, hi, &qh);
+
+    ql += lo;
+    qh += hi + (ql < lo) + 1;
+
+    limb_t r = lo - qh * d;
+
+    if (r > ql) { // the estimate is at most one too large ...
+        --qh;
+        r += d;
+    }
+
+    if (r >= d) { // ... or (rarely) one too small
+        ++qh;
+        r -= d;
+    }
+
+    *rem = r;
+    return qh;
+}
+
+/* calculates `a = a * m + c` and returns the carry out */
+static inline limb_t muladd_limb(limb_t a[], size_t n, limb_t m, limb_t c) {
+    for (size_t i = 0; i < n; ++i) {
+        limb_t hi, lo = mullimb(a[i], m, &hi);
+
+        lo += c;
+        c = hi + (lo < c);
+        a[i] = lo;
+    }
+
+    return c;
+}
+
+/* calculates `a = a / d` and returns the remainder */
+static inline limb_t divmod_limb(limb_t a[], size_t n, limb_t d) {
+    limb_t rem = 0;
+
+    for (size_t i = n; i-- > 0;)
+        a[i] = divlimb(rem, a[i], d, &rem);
+
+    return rem;
+}
+
+/* index of the most significant set bit (v != 0) */
+static inline int32_t msb_limb(limb_t v) {
+#if defined X86 && !defined X86_NO_LZCNT /* use `bsr` or `lzcnt` instruction */
+#if LIMB_BITS == 64
+    return __bsrq(v);
+#else
+    return _bit_scan_reverse(v);
+#endif
+#else
+    for (int32_t j = LIMB_BITS; j > 0; --j)
+        if (v & ((limb_t) 1 << (j - 1)))
+            return j - 1;
+    return -1;
+#endif
+}
+
+/* index of the least significant set bit (v != 0) */
+static inline int32_t lsb_limb(limb_t v) {
+#if defined X86 && !defined X86_NO_TZCNT /* use `bsf` or `tzcnt` instruction */
+#if LIMB_BITS == 64
+    return __bsfq(v);
+#else
+    return _bit_scan_forward(v);
+#endif
+#else
+    for (int32_t j = 0; j < LIMB_BITS; ++j)
+        if (v & ((limb_t) 1 << j))
+            return j;
+    return -1;
+#endif
+}
+
+/* calculates `a * b + c` (with 128-bit result) */
+static inline void muladd64(uint64_t r[2], uint64_t a, uint64_t b, uint64_t c) {
+#if LIMB_BITS == 64
+    dlimb_t p = (dlimb_t) a * b + c;
+    r[0] = (uint64_t) p;
+    r[1] = (uint64_t) (p >> 64);
+#else
+    uint64_t ll = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    uint64_t lh = (a & 0xFFFFFFFF) * (b >> 32);
+    uint64_t hl = (a >> 32) * (b & 0xFFFFFFFF);
+    uint64_t hh = (a >> 32) * (b >> 32);
+
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+
+    r[0] = (mid << 32) | (ll & 0xFFFFFFFF);
+    r[1] = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    r[0] += c;
+    r[1] += r[0] < c;
+#endif
+}
+
 /**
  * @param r[n] result
  * @param a[n] first operand
  * @param b[n] second operand
- * @param n number of 32-bit words
+ * @param n number of limbs
+ * @return the carry out
  */
-int __softfp_add(uint32_t r[], const uint32_t a[], const uint32_t b[], size_t n);
+int __softfp_add(limb_t r[], const limb_t a[], const limb_t b[], size_t n);
 
 /**
+ * calculates `|a - b|`
+ *
  * @param r[n] result
  * @param a[n] first operand
  * @param b[n] second operand
- * @param n number of 32-bit words
+ * @param n number of limbs
+ * @return 1 if `b > a`, 0 otherwise
  */
-int __softfp_sub(uint32_t r[], const uint32_t a[], const uint32_t b[], size_t n);
+int __softfp_sub(limb_t r[], const limb_t a[], const limb_t b[], size_t n);
 
 /**
+ * adds (or subtracts) `a * 2^shift` to (from) the two's complement fixed-point number `acc`. Bits above `acc[n-1]` are
+ * discarded.
+ *
+ * @param acc[n] accumulator
+ * @param n number of limbs in `acc`
+ * @param a[m] operand
+ * @param m number of limbs in `a`
+ * @param shift position of the operand's least significant bit in `acc`
+ * @param sub whether to subtract the operand
+ */
+void __softfp_acc_add(limb_t acc[], size_t n, const limb_t a[], size_t m, size_t shift, bool sub);
+
+/* upper bound for the operand size of `__softfp_mul_shr` */
+#define SOFTFP_MUL_MAX_LIMBS 32
+
+/**
+ * calculates the full product `a * b`
+ *
  * @param r[2*n] result
- * @param a[2*n] first operand (n bytes of data padded with n bytes of zeros)
+ * @param a[n] first operand
+ * @param b[n] second operand
+ * @param n number of limbs
+ */
+void __softfp_mul(limb_t r[], const limb_t a[], const limb_t b[], size_t n);
+
+/**
+ * calculates `(a * b) >> shift`, without storing the discarded lower half of the product. The result must fit into
+ * `n` limbs and `n` must not exceed `SOFTFP_MUL_MAX_LIMBS`.
+ *
+ * @param r[n] result
+ * @param a[n] first operand
  * @param b[n] second operand
- * @param n number of 32-bit words
+ * @param n number of limbs
+ * @param shift number of bits to discard
+ * @return the rounding bits (see `__softfp_arr_shift`)
  */
-int __softfp_mul(uint32_t r[], uint32_t a[], const uint32_t b[], size_t n);
+int __softfp_mul_shr(limb_t r[], const limb_t a[], const limb_t b[], size_t n, size_t shift);
 
-static inline int addsub(uint32_t r[], const uint32_t a[], const uint32_t b[], size_t n, bool sub) {
+static inline int addsub(limb_t r[], const limb_t a[], const limb_t b[], size_t n, bool sub) {
     return (sub ? __softfp_sub : __softfp_add)(r, a, b, n);
 }
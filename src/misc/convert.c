@@ -0,0 +1,120 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define SOFTFP_FENV
+#include "softfp.h"
+
+#include "convert.h"
+#include "cpu.h"
+
+#if SOFTFP_CONVERT_SIMD == 1
+
+#include "mxcsr.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+/* the same code is used for SSE2 and AVX2 (convert_avx2.c), only the vector width differs */
+#ifdef __AVX2__
+#define VLANES 4
+
+static inline void extend_lanes(uint64_t *z, const uint32_t *x) {
+    _mm256_storeu_pd((double *) z, _mm256_cvtps_pd(_mm_loadu_ps((const float *) x)));
+}
+
+static inline void trunc_lanes(uint32_t *z, const uint64_t *x) {
+    _mm_storeu_ps((float *) z, _mm256_cvtpd_ps(_mm256_loadu_pd((const double *) x)));
+}
+#else
+#define VLANES 2
+
+static inline void extend_lanes(uint64_t *z, const uint32_t *x) {
+    _mm_storeu_pd((double *) z, _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double *) x))));
+}
+
+static inline void trunc_lanes(uint32_t *z, const uint64_t *x) {
+    _mm_store_sd((double *) z, _mm_castps_pd(_mm_cvtpd_ps(_mm_loadu_pd((const double *) x))));
+}
+#endif
+
+/* the unused lanes of the last iteration convert 1.0, which raises no exceptions */
+#define SINGLE_ONE 0x3F800000
+#define DOUBLE_ONE 0x3FF0000000000000
+
+/* not inlined, so that the computations cannot be moved across the MXCSR accesses */
+static __attribute__((noinline)) void extend_loop(uint64_t z[], const uint32_t x[], size_t n) {
+    size_t i = 0;
+
+    for (; i + VLANES <= n; i += VLANES)
+        extend_lanes(&z[i], &x[i]);
+
+    if (i < n) {
+        uint32_t tx[VLANES];
+        uint64_t tz[VLANES];
+
+        for (size_t j = 0; j < VLANES; ++j)
+            tx[j] = SINGLE_ONE;
+
+        memcpy(tx, &x[i], (n - i) * sizeof *x);
+        extend_lanes(tz, tx);
+        memcpy(&z[i], tz, (n - i) * sizeof *z);
+    }
+}
+
+static __attribute__((noinline)) void trunc_loop(uint32_t z[], const uint64_t x[], size_t n) {
+    size_t i = 0;
+
+    for (; i + VLANES <= n; i += VLANES)
+        trunc_lanes(&z[i], &x[i]);
+
+    if (i < n) {
+        uint64_t tx[VLANES];
+        uint32_t tz[VLANES];
+
+        for (size_t j = 0; j < VLANES; ++j)
+            tx[j] = DOUBLE_ONE;
+
+        memcpy(tx, &x[i], (n - i) * sizeof *x);
+        trunc_lanes(tz, tx);
+        memcpy(&z[i], tz, (n - i) * sizeof *z);
+    }
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_convert_sfdf)(uint64_t z[], const uint32_t x[], size_t n) {
+    unsigned int csr = mxcsr_enter(FE_TONEAREST);
+    extend_loop(z, x, n);
+    return mxcsr_leave(csr);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_convert_dfsf)(uint32_t z[], const uint64_t x[], size_t n, int rm) {
+    unsigned int csr = mxcsr_enter(rm);
+    trunc_loop(z, x, n);
+    return mxcsr_leave(csr);
+}
+
+#if defined SOFTFP_DISPATCH && !defined SOFTFP_VARIANT
+KERNEL_DISPATCH_AVX2(int, __softfp_convert_sfdf, (uint64_t z[], const uint32_t x[], size_t n));
+KERNEL_DISPATCH_AVX2(int, __softfp_convert_dfsf, (uint32_t z[], const uint64_t x[], size_t n, int rm));
+#endif
+
+#endif
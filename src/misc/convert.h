@@ -0,0 +1,66 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "misc.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * lane-parallel conversions between binary32 and binary64, which use the conversion instructions of the FPU in the
+ * requested rounding mode. The FPU implements the same semantics as the scalar conversions (signaling NaNs are quieted
+ * and keep the most significant bits of their payload, tininess is detected after rounding). The kernels use SSE2 (2
+ * lanes) or, if available at runtime, AVX2 (4 lanes), see cpu.h.
+ */
+#if defined __SSE2__ || defined X86_64
+#define SOFTFP_CONVERT_SIMD 1
+#else
+#define SOFTFP_CONVERT_SIMD 0
+#endif
+
+#if SOFTFP_CONVERT_SIMD == 1
+
+/**
+ * converts `n` binary32 values to binary64 (exact)
+ *
+ * @param z[n] results
+ * @param x[n] binary32 values
+ * @param n number of elements
+ * @return the exceptions raised by any of the conversions (`SOFTFP_STATUS_*`)
+ */
+int __softfp_convert_sfdf(uint64_t z[], const uint32_t x[], size_t n);
+
+/**
+ * rounds `n` binary64 values to binary32
+ *
+ * @param z[n] results
+ * @param x[n] binary64 values
+ * @param n number of elements
+ * @param rm rounding mode
+ * @return the exceptions raised by any of the conversions (`SOFTFP_STATUS_*`)
+ */
+int __softfp_convert_dfsf(uint32_t z[], const uint64_t x[], size_t n, int rm);
+
+#endif
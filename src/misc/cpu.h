@@ -0,0 +1,117 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include "misc.h"
+
+/*
+ * runtime CPU dispatch: when built with SOFTFP_DISPATCH (x86-64 ELF targets, see CMakeLists.txt), the multiword kernels
+ * are compiled once for the baseline ISA and once per extension level (`*_bmi2.c`, `*_avx2.c`). GNU ifuncs select the
+ * best variant when the library is loaded, so a single binary runs everywhere without paying for the slowest variant.
+ */
+
+#define SOFTFP_CPU_BMI2 (1 << 0) // BMI2 and ADX (mulx, adcx, adox)
+#define SOFTFP_CPU_AVX2 (1 << 1) // AVX2 (implies SOFTFP_CPU_BMI2 and OS support for the YMM registers)
+
+#if defined SOFTFP_DISPATCH && !(defined X86_64 && defined __GNUC__ && defined __ELF__)
+#error "SOFTFP_DISPATCH requires an x86-64 ELF target and a GNU-compatible compiler"
+#endif
+
+#ifdef SOFTFP_DISPATCH
+
+#include <cpuid.h>
+
+/*
+ * returns the supported `SOFTFP_CPU_*` extensions. This is called from ifunc resolvers, i.e. before the relocations of
+ * the library are processed, so it must not call any other (non-inline) function.
+ */
+static inline int __softfp_cpu_features(void) {
+    unsigned int eax, ebx, ecx, edx;
+    int features = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+
+    // the OS saves the XMM and YMM registers on context switches
+    bool ymm = false;
+
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+        unsigned int xcr0, xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+        ymm = (xcr0 & 0x6) == 0x6;
+    }
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return 0;
+
+    if ((ebx & bit_BMI2) && (ebx & bit_ADX))
+        features |= SOFTFP_CPU_BMI2;
+
+    if (ymm && (ebx & bit_AVX2) && (features & SOFTFP_CPU_BMI2))
+        features |= SOFTFP_CPU_AVX2;
+
+    return features;
+}
+
+#define __X_KERNEL(name, variant) __XX_KERNEL(name, variant)
+#define __XX_KERNEL(name, variant) name##_##variant
+
+/* name of the current variant of the kernel `name` (`SOFTFP_VARIANT` is defined by the `*_bmi2.c` etc. files) */
+#ifdef SOFTFP_VARIANT
+#define KERNEL(name) __X_KERNEL(name, SOFTFP_VARIANT)
+#else
+#define KERNEL(name) name##_generic
+#endif
+
+/* the variants are only called via the dispatcher */
+#define KERNEL_LINKAGE __attribute__((visibility("hidden")))
+
+/* defines `name` as an ifunc selecting between the generic and the BMI2 variant */
+#define KERNEL_DISPATCH_BMI2(ret, name, params)                                                                        \
+    KERNEL_LINKAGE ret name##_generic params;                                                                          \
+    KERNEL_LINKAGE ret name##_bmi2 params;                                                                             \
+                                                                                                                       \
+    static ret(*name##_resolve(void)) params {                                                                         \
+        return (__softfp_cpu_features() & SOFTFP_CPU_BMI2) ? name##_bmi2 : name##_generic;                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    ret name params __attribute__((ifunc(#name "_resolve")))
+
+/* defines `name` as an ifunc selecting between the generic and the AVX2 variant */
+#define KERNEL_DISPATCH_AVX2(ret, name, params)                                                                        \
+    KERNEL_LINKAGE ret name##_generic params;                                                                          \
+    KERNEL_LINKAGE ret name##_avx2 params;                                                                             \
+                                                                                                                       \
+    static ret(*name##_resolve(void)) params {                                                                         \
+        return (__softfp_cpu_features() & SOFTFP_CPU_AVX2) ? name##_avx2 : name##_generic;                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    ret name params __attribute__((ifunc(#name "_resolve")))
+
+#else
+
+/* without dispatching, only the variant matching the compiler flags is built */
+#define KERNEL(name) name
+#define KERNEL_LINKAGE
+
+#endif
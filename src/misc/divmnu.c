@@ -1,94 +1,418 @@
-/*
- * Source: https://github.com/Clownacy/asl-releases/blob/master/math64.c
- * with slight modifications
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
  *
- * License: GPL-2.0
- * https://github.com/Clownacy/asl-releases/blob/master/COPYING
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
  *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
  */
-#include <stdint.h>
 
 #include "divmnu.h"
 
-static int nlz16(uint16_t n) {
-    unsigned z;
-    for (z = 0; z < 16; ++z) {
-        if (n & 0x8000u)
-            break;
-        n = n << 1;
-    }
-    return z;
+#include "arith.h"
+#include "cpu.h"
+#include "misc.h"
+
+#include <string.h>
+
+/* i-th limb of `v << s` (0 <= s < LIMB_BITS) */
+static inline limb_t shifted(const limb_t v[], size_t i, unsigned s) {
+    if (!s)
+        return v[i];
+
+    return (v[i] << s) | (i ? v[i - 1] >> (LIMB_BITS - s) : 0);
+}
+
+/* number of significant limbs in `a` */
+static inline size_t limbs(const limb_t a[], size_t n) {
+    while (n && !a[n - 1])
+        --n;
+
+    return n;
 }
 
-int __softfp_divmnu(uint16_t q[], uint16_t r[], const uint16_t u[], const uint16_t v[], int m, int n) {
-    const unsigned b = 65536;
-    uint16_t un[16], vn[16];
-    unsigned qhat;
-    unsigned rhat;
-    unsigned p;
-    int s, i, j, t, k;
+/* returns `a <=> b` */
+static inline int cmp(const limb_t a[], const limb_t b[], size_t n) {
+    while (n--)
+        if (a[n] != b[n])
+            return a[n] > b[n] ? 1 : -1;
+
+    return 0;
+}
 
-    if (m < n || n <= 0 || !v[n - 1])
+/* a += d, where `d` is either 1 or -1 */
+static inline void step(limb_t a[], size_t n, bool down) {
+    uint8_t carry = 1;
+
+    for (size_t i = 0; i < n && carry; ++i)
+        a[i] = down ? subborrow(a[i], 0, &carry) : addcarry(a[i], 0, &carry);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_divmnu)(limb_t q[], limb_t r[], limb_t u[], const limb_t v[], size_t m, size_t n) {
+    if (m < n || !n || !v[n - 1])
         return 1;
 
-    if (n == 1) {
-        k = 0;
-        for (j = m - 1; j >= 0; --j) {
-            q[j] = (k * b + u[j]) / v[0];
-            k = (k * b + u[j]) - q[j] * v[0];
-        }
+    if (n == 1) { // short division
+        limb_t rem = 0;
+
+        for (size_t j = m; j > 0; --j)
+            q[j - 1] = divlimb(rem, u[j - 1], v[0], &rem);
+
         if (r)
-            r[0] = k;
+            r[0] = rem;
+
         return 0;
     }
 
-    s = nlz16(v[n - 1]); /* 0 <= s <= 16. */
-    for (i = n - 1; i > 0; --i)
-        vn[i] = (v[i] << s) | (v[i - 1] >> (16 - s));
-    vn[0] = v[0] << s;
-    un[m] = u[m - 1] >> (16 - s);
-    for (i = m - 1; i > 0; --i)
-        un[i] = (u[i] << s) | (u[i - 1] >> (16 - s));
-    un[0] = u[0] << s;
-
-    for (j = m - n; j >= 0; --j) {
-        qhat = (un[j + n] * b + un[j + n - 1]) / vn[n - 1];
-        rhat = (un[j + n] * b + un[j + n - 1]) - qhat * vn[n - 1];
-    again:
-        if (qhat >= b || qhat * vn[n - 2] > b * rhat + un[j + n - 2]) {
-            qhat = qhat - 1;
-            rhat = rhat + vn[n - 1];
-            if (rhat < b)
-                goto again;
+    // normalize, so that the most significant bit of the divisor is set (the divisor is shifted on the fly)
+
+    const unsigned s = LIMB_BITS - 1 - msb_limb(v[n - 1]);
+    const limb_t v1 = shifted(v, n - 1, s);
+    const limb_t v2 = shifted(v, n - 2, s);
+
+    u[m] = s ? u[m - 1] >> (LIMB_BITS - s) : 0;
+
+    for (size_t i = m - 1; i > 0; --i)
+        u[i] = shifted(u, i, s);
+
+    u[0] <<= s;
+
+    for (size_t j = m - n + 1; j-- > 0;) {
+        limb_t qhat, rhat;
+        uint8_t overflow = 0; // rhat does not fit into a single limb
+
+        // estimate the quotient digit from the upper two limbs
+
+        if (u[j + n] >= v1) {
+            qhat = ~(limb_t) 0;
+            rhat = addcarry(u[j + n - 1], v1, &overflow);
+        } else
+            qhat = divlimb(u[j + n], u[j + n - 1], v1, &rhat);
+
+        while (!overflow) {
+            limb_t hi, lo = mullimb(qhat, v2, &hi);
+
+            if (hi < rhat || (hi == rhat && lo <= u[j + n - 2]))
+                break;
+
+            --qhat;
+            rhat = addcarry(rhat, v1, &overflow);
         }
 
-        k = 0;
-        for (i = 0; i < n; ++i) {
-            p = qhat * vn[i];
-            t = un[i + j] - k - (p & 0xFFFF);
-            un[i + j] = t;
-            k = (p >> 16) - (t >> 16);
+        // u[j..j+n] -= qhat * v
+
+        limb_t k = 0;
+        uint8_t borrow;
+
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t carry = 0;
+            limb_t hi, lo = mullimb(qhat, shifted(v, i, s), &hi);
+
+            lo = addcarry(lo, k, &carry);
+            hi += carry;
+
+            borrow = 0;
+            u[i + j] = subborrow(u[i + j], lo, &borrow);
+            k = hi + borrow;
         }
-        t = un[j + n] - k;
-        un[j + n] = t;
 
-        q[j] = qhat;
+        borrow = 0;
+        u[j + n] = subborrow(u[j + n], k, &borrow);
 
-        if (t < 0) {
-            q[j] = q[j] - 1;
-            k = 0;
-            for (i = 0; i < n; ++i) {
-                t = un[i + j] + vn[i] + k;
-                un[i + j] = t;
-                k = t >> 16;
-            }
-            un[j + n] = un[j + n] + k;
+        if (borrow) { // qhat was one too large, add the divisor back
+            uint8_t carry = 0;
+
+            --qhat;
+
+            for (size_t i = 0; i < n; ++i)
+                u[i + j] = addcarry(u[i + j], shifted(v, i, s), &carry);
+
+            u[j + n] += carry;
         }
+
+        q[j] = qhat;
     }
 
     if (r)
-        for (i = 0; i < n; ++i)
-            r[i] = (un[i] >> s) | (un[i + 1] << (16 - s));
+        for (size_t i = 0; i < n; ++i)
+            r[i] = s ? (u[i] >> s) | (u[i + 1] << (LIMB_BITS - s)) : u[i];
 
     return 0;
 }
+
+static int div_knuth(limb_t q[], const limb_t a[], const limb_t b[], size_t n, size_t shift) {
+    limb_t u[SOFTFP_MUL_MAX_LIMBS + 1] = {0};
+    limb_t quot[SOFTFP_MUL_MAX_LIMBS + 1];
+    limb_t rem[SOFTFP_MUL_MAX_LIMBS / 2];
+
+    memcpy(u, a, n * sizeof(limb_t));
+    __softfp_arr_shift(u, 2 * n, shift);
+
+    const size_t nu = limbs(u, 2 * n);
+    const size_t nb = limbs(b, n);
+
+    memset(q, 0, n * sizeof(limb_t));
+
+    if (nu < nb) // the quotient is zero
+        return nu ? BIT_STICKY : 0;
+
+    KERNEL(__softfp_divmnu)(quot, rem, u, b, nu, nb);
+    memcpy(q, quot, MIN(n, nu - nb + 1) * sizeof(limb_t));
+
+    return limbs(rem, nb) ? BIT_STICKY : 0;
+}
+
+/*
+ * With B = n * LIMB_BITS and the divisor normalized to V = b << sb (2^(B-1) <= V < 2^B), X approximates 2^2B / V
+ * using the iteration X' = X + X * (2^2B - V * X) / 2^2B, which doubles the number of correct bits each time.
+ * The quotient estimate (a << shift) * X / 2^(2B - sb) is then corrected by multiplying it back.
+ */
+static int div_newton(limb_t q[], const limb_t a[], const limb_t b[], size_t n, size_t shift) {
+    const size_t bits = n * LIMB_BITS;
+    const size_t nw = n + 1; // working precision (X may exceed 2^B)
+    const size_t sb = bits - 1 - __softfp_bitscan(b, n, true);
+
+    limb_t v[SOFTFP_MUL_MAX_LIMBS / 2 + 1] = {0};
+    limb_t x[SOFTFP_MUL_MAX_LIMBS / 2 + 1] = {0};
+    limb_t t[SOFTFP_MUL_MAX_LIMBS + 2];
+    limb_t p[SOFTFP_MUL_MAX_LIMBS + 2];
+    limb_t d[SOFTFP_MUL_MAX_LIMBS + 2];
+
+    memcpy(v, b, n * sizeof(limb_t));
+    __softfp_arr_shift(v, n, sb);
+
+    // initial estimate from the most significant limb
+
+    dlimb_t x0 = ~(dlimb_t) 0 / v[n - 1];
+    x[n - 1] = (limb_t) x0;
+    x[n] = (limb_t) (x0 >> LIMB_BITS);
+
+    for (size_t prec = LIMB_BITS - 2; prec < bits + 2; prec *= 2) {
+        memset(t, 0, 2 * nw * sizeof(limb_t));
+        t[2 * n] = 1;
+
+        // d = |2^2B - V * X|
+
+        __softfp_mul(p, v, x, nw);
+        bool over = __softfp_sub(d, t, p, 2 * nw);
+
+        // X +-= X * (d >> B) >> B
+
+        __softfp_mul(p, x, &d[n], nw);
+
+        if (over)
+            __softfp_sub(x, x, &p[n], nw);
+        else
+            __softfp_add(x, x, &p[n], nw);
+    }
+
+    // estimate the quotient (never off by more than a few units)
+
+    limb_t qe[SOFTFP_MUL_MAX_LIMBS / 2 + 1] = {0};
+    limb_t ae[SOFTFP_MUL_MAX_LIMBS / 2 + 1] = {0};
+
+    memcpy(ae, a, n * sizeof(limb_t));
+    __softfp_mul_shr(qe, ae, x, nw, 2 * bits - shift - sb);
+
+    // t = a << shift, d = b, p = qe * b
+
+    memset(t, 0, 2 * nw * sizeof(limb_t));
+    memcpy(t, a, n * sizeof(limb_t));
+    __softfp_arr_shift(t, 2 * nw, shift);
+
+    memset(d, 0, 2 * nw * sizeof(limb_t));
+    memcpy(d, b, n * sizeof(limb_t));
+
+    __softfp_mul(p, qe, d, nw);
+
+    while (cmp(p, t, 2 * nw) > 0) {
+        step(qe, nw, true);
+        __softfp_sub(p, p, d, 2 * nw);
+    }
+
+    __softfp_sub(p, t, p, 2 * nw); // remainder
+
+    while (cmp(p, d, 2 * nw) >= 0) {
+        step(qe, nw, false);
+        __softfp_sub(p, p, d, 2 * nw);
+    }
+
+    memcpy(q, qe, n * sizeof(limb_t));
+
+    return limbs(p, 2 * nw) ? BIT_STICKY : 0;
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_div_shl)(limb_t q[], const limb_t a[], const limb_t b[], size_t n, size_t shift) {
+    if (n >= SOFTFP_NEWTON_THRESHOLD)
+        return div_newton(q, a, b, n, shift);
+
+    return div_knuth(q, a, b, n, shift);
+}
+
+/* restoring square root of `m`, two bits of the radicand (one bit of the root) per step */
+static limb_t isqrt_dlimb(dlimb_t m, dlimb_t *rem) {
+    dlimb_t r = 0;
+    limb_t root = 0;
+
+    *rem = 0;
+
+    if (!m)
+        return 0;
+
+    int32_t top = (limb_t) (m >> LIMB_BITS) ? LIMB_BITS + msb_limb((limb_t) (m >> LIMB_BITS)) : msb_limb((limb_t) m);
+
+    for (int32_t i = top & ~1; i >= 0; i -= 2) {
+        r = (r << 2) | ((m >> i) & 3);
+
+        dlimb_t trial = ((dlimb_t) root << 2) | 1; // (2 * root + 1) for the next bit of the root
+
+        root <<= 1;
+
+        if (r >= trial) {
+            r -= trial;
+            root |= 1;
+        }
+    }
+
+    *rem = r;
+    return root;
+}
+
+static int sqrt_digits(limb_t r[], const limb_t a[], size_t shift) {
+    dlimb_t rem;
+
+    r[0] = isqrt_dlimb(a[0] ? (dlimb_t) a[0] << shift : 0, &rem);
+
+    return rem ? BIT_STICKY : 0;
+}
+
+/*
+ * With B = n * LIMB_BITS and the radicand normalized to V = (a << shift) << sv (2^(2B-2) <= V < 2^2B, sv even), X
+ * approximates 2^2B / sqrt(V) using the iteration X' = X + X * (1 - V * X^2 / 2^4B) / 2, which doubles the number of
+ * correct bits each time. The root estimate V * X / 2^(2B + sv/2) is then corrected by squaring it.
+ */
+static int sqrt_newton(limb_t r[], const limb_t a[], size_t n, size_t shift) {
+    const size_t bits = n * LIMB_BITS;
+    const size_t nw = n + 1; // working precision (X may exceed 2^B)
+
+    limb_t m[SOFTFP_MUL_MAX_LIMBS + 2] = {0};
+    limb_t v[SOFTFP_MUL_MAX_LIMBS] = {0};
+    limb_t x[SOFTFP_MUL_MAX_LIMBS] = {0};
+    limb_t t[SOFTFP_MUL_MAX_LIMBS] = {0};
+    limb_t p[2 * SOFTFP_MUL_MAX_LIMBS];
+    limb_t d[2 * SOFTFP_MUL_MAX_LIMBS];
+
+    memcpy(m, a, n * sizeof(limb_t));
+    __softfp_arr_shift(m, 2 * nw, shift);
+
+    int32_t lead = __softfp_bitscan(m, 2 * n, true);
+
+    memset(r, 0, n * sizeof(limb_t));
+
+    if (lead < 0)
+        return 0;
+
+    const size_t sv = (2 * bits - 1 - lead) & ~(size_t) 1;
+
+    memcpy(v, m, 2 * n * sizeof(limb_t));
+    __softfp_arr_shift(v, 2 * n, sv);
+
+    // initial estimate from the two most significant limbs
+
+    dlimb_t rem;
+    limb_t s = isqrt_dlimb(((dlimb_t) v[2 * n - 1] << LIMB_BITS) | v[2 * n - 2], &rem);
+    dlimb_t x0 = ~(dlimb_t) 0 / s;
+
+    x[n - 1] = (limb_t) x0;
+    x[n] = (limb_t) (x0 >> LIMB_BITS);
+
+    for (size_t prec = LIMB_BITS - 2; prec < bits + 2; prec *= 2) {
+        // t = X^2 >> B
+
+        __softfp_mul(p, x, x, nw);
+        memcpy(t, &p[n], nw * sizeof(limb_t));
+
+        // d = |2^3B - V * t|
+
+        __softfp_mul(p, v, t, 2 * n);
+        memset(d, 0, 4 * n * sizeof(limb_t));
+        d[3 * n] = 1;
+
+        bool over = __softfp_sub(d, d, p, 4 * n);
+
+        // X +-= X * (d >> 2B) >> (B + 1)
+
+        __softfp_mul_shr(t, x, &d[2 * n], nw, bits + 1);
+
+        if (over)
+            __softfp_sub(x, x, t, nw);
+        else
+            __softfp_add(x, x, t, nw);
+
+        memset(t, 0, 2 * n * sizeof(limb_t));
+    }
+
+    // estimate the root (never off by more than a few units)
+
+    limb_t re[SOFTFP_MUL_MAX_LIMBS / 2 + 1];
+
+    __softfp_mul(p, v, x, 2 * n);
+    memcpy(re, &p[2 * n], nw * sizeof(limb_t));
+    __softfp_arr_shift(re, nw, -(int32_t) (sv / 2));
+
+    // correct the estimate, so that re^2 <= m < (re + 1)^2
+
+    for (;;) {
+        __softfp_mul(p, re, re, nw);
+
+        if (cmp(p, m, 2 * nw) <= 0)
+            break;
+
+        step(re, nw, true);
+    }
+
+    for (;;) {
+        limb_t next[SOFTFP_MUL_MAX_LIMBS / 2 + 1];
+
+        memcpy(next, re, nw * sizeof(limb_t));
+        step(next, nw, false);
+        __softfp_mul(d, next, next, nw);
+
+        if (cmp(d, m, 2 * nw) > 0)
+            break;
+
+        memcpy(re, next, nw * sizeof(limb_t));
+        memcpy(p, d, 2 * nw * sizeof(limb_t));
+    }
+
+    memcpy(r, re, n * sizeof(limb_t));
+
+    return cmp(p, m, 2 * nw) ? BIT_STICKY : 0;
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_sqrt_shl)(limb_t r[], const limb_t a[], size_t n, size_t shift) {
+    if (n == 1)
+        return sqrt_digits(r, a, shift);
+
+    return sqrt_newton(r, a, n, shift);
+}
+
+#if defined SOFTFP_DISPATCH && !defined SOFTFP_VARIANT
+KERNEL_DISPATCH_BMI2(int, __softfp_divmnu, (limb_t q[], limb_t r[], limb_t u[], const limb_t v[], size_t m, size_t n));
+KERNEL_DISPATCH_BMI2(int, __softfp_div_shl, (limb_t q[], const limb_t a[], const limb_t b[], size_t n, size_t shift));
+KERNEL_DISPATCH_BMI2(int, __softfp_sqrt_shl, (limb_t r[], const limb_t a[], size_t n, size_t shift));
+#endif
@@ -23,18 +23,56 @@
 
 #pragma once
 
+#include "arith.h"
+#include "misc.h"
+
+#include <stddef.h>
 #include <stdint.h>
 
-int __softfp_divmnu(uint16_t q[], uint16_t r[], const uint16_t u[], const uint16_t v[], int m, int n);
+/*
+ * operands with at least this many limbs are divided using a Newton-Raphson reciprocal instead of Knuth's algorithm D.
+ * Algorithm D is faster for every operand size `__softfp_div_shl` supports (up to 16 limbs), so the reciprocal path is
+ * disabled by default.
+ */
+#ifndef SOFTFP_NEWTON_THRESHOLD
+#define SOFTFP_NEWTON_THRESHOLD (SOFTFP_MUL_MAX_LIMBS / 2 + 1)
+#endif
 
 /**
+ * Knuth's algorithm D (TAOCP Vol. 2, 4.3.1)
+ *
  * @param q[m-n+1] quotient
- * @param r[n] remainder
- * @param u[m] dividend
+ * @param r[n] remainder (may be NULL)
+ * @param u[m+1] dividend, overwritten during the division (`u[m]` does not need to be initialized)
  * @param v[n] divisor
- * @param m number of 32-bit words in u
- * @param n number of 32-bit words in v (m >= n)
+ * @param m number of limbs in u
+ * @param n number of limbs in v (m >= n, `v[n-1] != 0`)
+ * @return 1 if the arguments are invalid, 0 otherwise
+ */
+int __softfp_divmnu(limb_t q[], limb_t r[], limb_t u[], const limb_t v[], size_t m, size_t n);
+
+/**
+ * calculates `(a << shift) / b`. The shifted dividend must fit into `2*n` limbs, the quotient must fit into `n` limbs
+ * and `n` must not exceed `SOFTFP_MUL_MAX_LIMBS / 2`.
+ *
+ * @param q[n] quotient
+ * @param a[n] dividend
+ * @param b[n] divisor (b != 0)
+ * @param n number of limbs
+ * @param shift number of bits the dividend is shifted to the left
+ * @return `BIT_STICKY` if the remainder is not zero, 0 otherwise
+ */
+int __softfp_div_shl(limb_t q[], const limb_t a[], const limb_t b[], size_t n, size_t shift);
+
+/**
+ * calculates `floor(sqrt(a << shift))`. The shifted radicand must fit into `2*n` limbs and `n` must not exceed
+ * `SOFTFP_MUL_MAX_LIMBS / 2`. Single-limb roots are calculated bit by bit (digit recurrence), wider ones using a
+ * Newton-Raphson iteration for the reciprocal square root.
+ *
+ * @param r[n] root
+ * @param a[n] radicand
+ * @param n number of limbs
+ * @param shift number of bits the radicand is shifted to the left
+ * @return `BIT_STICKY` if the remainder is not zero (i.e., the root is inexact), 0 otherwise
  */
-static inline int divmnu(uint32_t q[], uint32_t r[], const uint32_t u[], const uint32_t v[], int m, int n) {
-    return __softfp_divmnu((uint16_t *) q, (uint16_t *) r, (const uint16_t *) u, (const uint16_t *) v, m * 2, n * 2);
-}
+int __softfp_sqrt_shl(limb_t r[], const limb_t a[], size_t n, size_t shift);
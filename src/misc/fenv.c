@@ -87,7 +87,7 @@ int __softfp_fegetround(void) {
 }
 
 int __softfp_fesetround(int round) {
-    fenv |= (round & 3) << ROUND_OFFSET;
+    fenv = (fenv & ~(3 << ROUND_OFFSET)) | ((round & 3) << ROUND_OFFSET);
     return 0;
 }
 
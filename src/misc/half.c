@@ -0,0 +1,436 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define SOFTFP_FENV
+#include "softfp.h"
+
+#include "cpu.h"
+#include "half.h"
+
+#if SOFTFP_HALF_SIMD == 1
+
+#include "mxcsr.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+/* the same code is used for SSE2 and AVX2 (half_avx2.c), only the vector width differs */
+#ifdef __AVX2__
+#define VLANES 8
+
+typedef __m256 vfloat_t;
+typedef __m256i vint_t;
+
+#define VI(c) _mm256_set1_epi32((int) (c))
+#define VI_AND _mm256_and_si256
+#define VI_ANDNOT _mm256_andnot_si256
+#define VI_OR _mm256_or_si256
+#define VI_ADD _mm256_add_epi32
+#define VI_SUB _mm256_sub_epi32
+#define VI_SLL _mm256_slli_epi32
+#define VI_SRL _mm256_srli_epi32
+#define VI_SRA _mm256_srai_epi32
+#define VI_EQ _mm256_cmpeq_epi32
+#define VI_GT _mm256_cmpgt_epi32
+#define VI_ANY(a) (!_mm256_testz_si256((a), (a)))
+
+#define VF(c) _mm256_set1_ps(c)
+#define VF_ADD _mm256_add_ps
+#define VF_SUB _mm256_sub_ps
+#define VF_MUL _mm256_mul_ps
+#define VF_DIV _mm256_div_ps
+#define VF_NE(a, b) _mm256_castps_si256(_mm256_cmp_ps((a), (b), _CMP_NEQ_UQ))
+#define VF_FROM_INT _mm256_cvtepi32_ps
+#define VF_TO_INT _mm256_cvttps_epi32
+#define VF_AS_INT _mm256_castps_si256
+#define VI_AS_FLOAT _mm256_castsi256_ps
+
+/* zero-extends VLANES binary16 values into 32-bit lanes */
+static inline vint_t half_load(const uint16_t *p) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) p));
+}
+
+/* stores the lower halves of the 32-bit lanes */
+static inline void half_store(uint16_t *p, vint_t v) {
+    v = VI_SRA(VI_SLL(v, 16), 16); // packs saturates signed values
+    _mm_storeu_si128((__m128i *) p, _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+static inline vint_t single_load(const uint32_t *p) {
+    return _mm256_loadu_si256((const __m256i *) p);
+}
+
+static inline void single_store(uint32_t *p, vint_t v) {
+    _mm256_storeu_si256((__m256i *) p, v);
+}
+#else
+#define VLANES 4
+
+typedef __m128 vfloat_t;
+typedef __m128i vint_t;
+
+#define VI(c) _mm_set1_epi32((int) (c))
+#define VI_AND _mm_and_si128
+#define VI_ANDNOT _mm_andnot_si128
+#define VI_OR _mm_or_si128
+#define VI_ADD _mm_add_epi32
+#define VI_SUB _mm_sub_epi32
+#define VI_SLL _mm_slli_epi32
+#define VI_SRL _mm_srli_epi32
+#define VI_SRA _mm_srai_epi32
+#define VI_EQ _mm_cmpeq_epi32
+#define VI_GT _mm_cmpgt_epi32
+#define VI_ANY(a) (_mm_movemask_epi8(a) != 0)
+
+#define VF(c) _mm_set1_ps(c)
+#define VF_ADD _mm_add_ps
+#define VF_SUB _mm_sub_ps
+#define VF_MUL _mm_mul_ps
+#define VF_DIV _mm_div_ps
+#define VF_NE(a, b) _mm_castps_si128(_mm_cmpneq_ps((a), (b)))
+#define VF_FROM_INT _mm_cvtepi32_ps
+#define VF_TO_INT _mm_cvttps_epi32
+#define VF_AS_INT _mm_castps_si128
+#define VI_AS_FLOAT _mm_castsi128_ps
+
+static inline vint_t half_load(const uint16_t *p) {
+    return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) p), _mm_setzero_si128());
+}
+
+static inline void half_store(uint16_t *p, vint_t v) {
+    v = VI_SRA(VI_SLL(v, 16), 16);
+    _mm_storel_epi64((__m128i *) p, _mm_packs_epi32(v, v));
+}
+
+static inline vint_t single_load(const uint32_t *p) {
+    return _mm_loadu_si128((const __m128i *) p);
+}
+
+static inline void single_store(uint32_t *p, vint_t v) {
+    _mm_storeu_si128((__m128i *) p, v);
+}
+#endif
+
+/* (m & a) | (~m & b) */
+#define VI_SEL(m, a, b) VI_OR(VI_AND((m), (a)), VI_ANDNOT((m), (b)))
+
+#define HALF_ONE 0x3C00
+#define SINGLE_ONE 0x3F800000
+
+enum half_op { HALF_ADD, HALF_SUB, HALF_MUL, HALF_DIV };
+
+/* the per-lane exceptions which are not reported by the FPU */
+typedef struct {
+    vint_t invalid;
+    vint_t denorm;
+    vint_t overflow;
+    vint_t underflow;
+} half_flags_t;
+
+/* converts binary16 to binary32 (exact, signaling NaNs stay signaling) */
+static inline vfloat_t half_widen(vint_t h) {
+    vint_t t = VI_SLL(VI_AND(h, VI(0x7FFF)), 13);
+    vint_t e = VI_AND(h, VI(0x7C00));
+
+    vint_t normal = VI_ADD(t, VI(112 << 23));  // rebias the exponent (127 - 15)
+    vint_t special = VI_ADD(t, VI(224 << 23)); // exponent 31 becomes 255
+    vint_t denormal = VF_AS_INT(VF_MUL(VF_FROM_INT(VI_AND(h, VI(0x3FF))), VF(0x1p-24f)));
+
+    vint_t r = VI_SEL(VI_EQ(e, VI(0x7C00)), special, VI_SEL(VI_EQ(e, VI(0)), denormal, normal));
+
+    return VI_AS_FLOAT(VI_OR(r, VI_SLL(VI_AND(h, VI(0x8000)), 16)));
+}
+
+/*
+ * rounds the binary32 values `f` to binary16 in the current (MXCSR) rounding mode. `ovf_pos` and `ovf_neg` are the
+ * magnitudes of positive and negative overflowing results (infinity or the largest finite value, depending on the
+ * rounding mode).
+ */
+static inline vint_t half_narrow(vfloat_t f, vint_t ovf_pos, vint_t ovf_neg, half_flags_t *flags) {
+    vint_t bits = VF_AS_INT(f);
+    vint_t sign = VI_AND(bits, VI(0x80000000));
+    vint_t abs = VI_AND(bits, VI(0x7FFFFFFF));
+
+    vint_t finite = VI_GT(VI(0x7F800000), abs);
+    vfloat_t fin = VI_AS_FLOAT(VI_AND(bits, finite));
+    vint_t exp = VI_AND(VF_AS_INT(fin), VI(0x7F800000));
+
+    /*
+     * adding (and subtracting) 2^(e+13), where `e` is the exponent of `f`, rounds `f` to 11 significant bits. The
+     * exponent is clamped to the minimum binary16 exponent, so that denormal results are rounded as well.
+     */
+    vint_t expc = VI_SEL(VI_GT(exp, VI(0x38800000)), exp, VI(0x38800000));
+    vfloat_t magic = VI_AS_FLOAT(VI_OR(VI_ADD(expc, VI(13 << 23)), sign));
+    vfloat_t r = VF_SUB(VF_ADD(fin, magic), magic);
+
+    vint_t inexact = VF_NE(r, fin);
+
+    // tininess is detected after rounding (with an unbounded exponent range), as in __softfp_round
+    vfloat_t magicu = VI_AS_FLOAT(VI_OR(VI_ADD(exp, VI(13 << 23)), sign));
+    vfloat_t ru = VF_SUB(VF_ADD(fin, magicu), magicu);
+
+    vint_t nonzero = VI_GT(VI_AND(VF_AS_INT(fin), VI(0x7FFFFFFF)), VI(0));
+    vint_t tiny = VI_AND(nonzero, VI_GT(VI(0x38800000), VI_AND(VF_AS_INT(ru), VI(0x7FFFFFFF))));
+
+    flags->underflow = VI_OR(flags->underflow, VI_AND(tiny, inexact));
+
+    // the rounded value is exactly representable, so it only has to be repacked
+    vint_t rabs = VI_AND(VF_AS_INT(r), VI(0x7FFFFFFF));
+    vint_t isnormal = VI_GT(rabs, VI(0x387FFFFF));
+
+    // the conversion to integer is only done for denormals (it would raise FE_INVALID for large values)
+    vint_t normal = VI_SRL(VI_SUB(rabs, VI(112 << 23)), 13);
+    vint_t denormal = VF_TO_INT(VF_MUL(VI_AS_FLOAT(VI_ANDNOT(isnormal, rabs)), VF(0x1p24f)));
+
+    vint_t h = VI_SEL(isnormal, normal, denormal);
+
+    vint_t overflow = VI_AND(finite, VI_GT(rabs, VI(0x477FFFFF)));
+    flags->overflow = VI_OR(flags->overflow, overflow);
+
+    h = VI_SEL(overflow, VI_SEL(VI_EQ(sign, VI(0)), ovf_pos, ovf_neg), h);
+
+    // infinities stay infinities, NaNs produced by the operation become the default NaN
+    h = VI_SEL(VI_EQ(abs, VI(0x7F800000)), VI(0x7C00), h);
+    h = VI_SEL(VI_GT(abs, VI(0x7F800000)), VI(0x7E00), h);
+
+    return VI_OR(h, VI_SRL(sign, 16));
+}
+
+static inline vint_t half_op(vint_t x, vint_t y, enum half_op op, vint_t ovf_pos, vint_t ovf_neg,
+                             half_flags_t *flags) {
+    vfloat_t a = half_widen(x);
+    vfloat_t b = half_widen(y);
+    vfloat_t f;
+
+    switch (op) {
+    case HALF_ADD:
+        f = VF_ADD(a, b);
+        break;
+    case HALF_SUB:
+        f = VF_SUB(a, b);
+        break;
+    case HALF_MUL:
+        f = VF_MUL(a, b);
+        break;
+    default:
+        f = VF_DIV(a, b);
+        break;
+    }
+
+    vint_t z = half_narrow(f, ovf_pos, ovf_neg, flags);
+
+    // NaN operands are propagated (quieted), the first operand takes precedence
+    vint_t xabs = VI_AND(x, VI(0x7FFF));
+    vint_t yabs = VI_AND(y, VI(0x7FFF));
+    vint_t xnan = VI_GT(xabs, VI(0x7C00));
+    vint_t ynan = VI_GT(yabs, VI(0x7C00));
+
+    z = VI_SEL(ynan, VI_OR(y, VI(0x200)), z);
+    z = VI_SEL(xnan, VI_OR(x, VI(0x200)), z);
+
+    vint_t xden = VI_AND(VI_GT(xabs, VI(0)), VI_GT(VI(0x400), xabs));
+    vint_t yden = VI_AND(VI_GT(yabs, VI(0)), VI_GT(VI(0x400), yabs));
+
+    flags->denorm = VI_OR(flags->denorm, VI_ANDNOT(VI_OR(xnan, ynan), VI_OR(xden, yden)));
+
+    return z;
+}
+
+/* collects the per-lane exceptions */
+static inline int half_status(const half_flags_t *flags) {
+    int status = 0;
+
+    if (VI_ANY(flags->invalid))
+        status |= SOFTFP_STATUS_INVALID;
+
+    if (VI_ANY(flags->denorm))
+        status |= SOFTFP_STATUS_DENORM;
+
+    if (VI_ANY(flags->overflow))
+        status |= SOFTFP_STATUS_OVERFLOW | SOFTFP_STATUS_INEXACT;
+
+    if (VI_ANY(flags->underflow))
+        status |= SOFTFP_STATUS_UNDERFLOW;
+
+    return status;
+}
+
+/* not inlined, so that the computations cannot be moved across the MXCSR accesses in half_run */
+static __attribute__((noinline)) int half_loop(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n,
+                                               enum half_op op, int rm) {
+    vint_t ovf_pos = VI(rm == FE_TONEAREST || rm == FE_UPWARD ? 0x7C00 : 0x7BFF);
+    vint_t ovf_neg = VI(rm == FE_TONEAREST || rm == FE_DOWNWARD ? 0x7C00 : 0x7BFF);
+
+    half_flags_t flags = {VI(0), VI(0), VI(0), VI(0)};
+    size_t i = 0;
+
+    for (; i + VLANES <= n; i += VLANES)
+        half_store(&z[i], half_op(half_load(&x[i]), half_load(&y[i]), op, ovf_pos, ovf_neg, &flags));
+
+    if (i < n) { // the unused lanes calculate 1 op 1, which raises no exceptions
+        uint16_t tx[VLANES], ty[VLANES], tz[VLANES];
+
+        for (size_t j = 0; j < VLANES; ++j)
+            tx[j] = ty[j] = HALF_ONE;
+
+        memcpy(tx, &x[i], (n - i) * sizeof *x);
+        memcpy(ty, &y[i], (n - i) * sizeof *y);
+
+        half_store(tz, half_op(half_load(tx), half_load(ty), op, ovf_pos, ovf_neg, &flags));
+
+        memcpy(&z[i], tz, (n - i) * sizeof *z);
+    }
+
+    return half_status(&flags);
+}
+
+/* converts binary16 to binary32 (signaling NaNs are quieted) */
+static inline vint_t half_extend(vint_t x, half_flags_t *flags) {
+    vint_t xabs = VI_AND(x, VI(0x7FFF));
+    vint_t snan = VI_AND(VI_GT(xabs, VI(0x7C00)), VI_GT(VI(0x7E00), xabs));
+
+    flags->invalid = VI_OR(flags->invalid, snan);
+    flags->denorm = VI_OR(flags->denorm, VI_AND(VI_GT(xabs, VI(0)), VI_GT(VI(0x400), xabs)));
+
+    return VI_OR(VF_AS_INT(half_widen(x)), VI_AND(snan, VI(0x400000)));
+}
+
+/* rounds binary32 to binary16, NaNs keep the most significant bits of their payload */
+static inline vint_t half_trunc(vint_t x, vint_t ovf_pos, vint_t ovf_neg, half_flags_t *flags) {
+    vint_t xabs = VI_AND(x, VI(0x7FFFFFFF));
+    vint_t nan = VI_GT(xabs, VI(0x7F800000));
+    vint_t snan = VI_AND(nan, VI_GT(VI(0x7FC00000), xabs));
+
+    flags->invalid = VI_OR(flags->invalid, snan);
+    flags->denorm = VI_OR(flags->denorm, VI_AND(VI_GT(xabs, VI(0)), VI_GT(VI(0x800000), xabs)));
+
+    // values beyond 2^16 overflow anyway, clamping them keeps the rounding constants in half_narrow finite
+    vint_t big = VI_AND(VI_GT(xabs, VI(0x47800000)), VI_GT(VI(0x7F800000), xabs));
+    vint_t f = VI_SEL(big, VI_OR(VI_ANDNOT(VI(0x7FFFFFFF), x), VI(0x47800000)), x);
+
+    vint_t z = half_narrow(VI_AS_FLOAT(f), ovf_pos, ovf_neg, flags);
+    vint_t payload = VI_OR(VI_AND(VI_SRL(x, 16), VI(0x8000)), VI_OR(VI(0x7E00), VI_AND(VI_SRL(x, 13), VI(0x3FF))));
+
+    return VI_SEL(nan, payload, z);
+}
+
+static __attribute__((noinline)) int half_extend_loop(uint32_t z[], const uint16_t x[], size_t n) {
+    half_flags_t flags = {VI(0), VI(0), VI(0), VI(0)};
+    size_t i = 0;
+
+    for (; i + VLANES <= n; i += VLANES)
+        single_store(&z[i], half_extend(half_load(&x[i]), &flags));
+
+    if (i < n) {
+        uint16_t tx[VLANES];
+        uint32_t tz[VLANES];
+
+        for (size_t j = 0; j < VLANES; ++j)
+            tx[j] = HALF_ONE;
+
+        memcpy(tx, &x[i], (n - i) * sizeof *x);
+
+        single_store(tz, half_extend(half_load(tx), &flags));
+
+        memcpy(&z[i], tz, (n - i) * sizeof *z);
+    }
+
+    return half_status(&flags);
+}
+
+static __attribute__((noinline)) int half_trunc_loop(uint16_t z[], const uint32_t x[], size_t n, int rm) {
+    vint_t ovf_pos = VI(rm == FE_TONEAREST || rm == FE_UPWARD ? 0x7C00 : 0x7BFF);
+    vint_t ovf_neg = VI(rm == FE_TONEAREST || rm == FE_DOWNWARD ? 0x7C00 : 0x7BFF);
+
+    half_flags_t flags = {VI(0), VI(0), VI(0), VI(0)};
+    size_t i = 0;
+
+    for (; i + VLANES <= n; i += VLANES)
+        half_store(&z[i], half_trunc(single_load(&x[i]), ovf_pos, ovf_neg, &flags));
+
+    if (i < n) {
+        uint32_t tx[VLANES];
+        uint16_t tz[VLANES];
+
+        for (size_t j = 0; j < VLANES; ++j)
+            tx[j] = SINGLE_ONE;
+
+        memcpy(tx, &x[i], (n - i) * sizeof *x);
+
+        half_store(tz, half_trunc(single_load(tx), ovf_pos, ovf_neg, &flags));
+
+        memcpy(&z[i], tz, (n - i) * sizeof *z);
+    }
+
+    return half_status(&flags);
+}
+
+/*
+ * runs the kernel in the requested rounding mode. The FPU never sees overflows, underflows or denormals (every binary16
+ * value and every intermediate result is a normal binary32 number), these are detected per lane by half_narrow.
+ */
+static int half_run(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, enum half_op op, int rm) {
+    unsigned int csr = mxcsr_enter(rm);
+    int status = half_loop(z, x, y, n, op, rm);
+
+    return status | mxcsr_leave(csr);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_half_add)(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm) {
+    return half_run(z, x, y, n, HALF_ADD, rm);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_half_sub)(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm) {
+    return half_run(z, x, y, n, HALF_SUB, rm);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_half_mul)(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm) {
+    return half_run(z, x, y, n, HALF_MUL, rm);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_half_div)(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm) {
+    return half_run(z, x, y, n, HALF_DIV, rm);
+}
+
+/* the conversion is exact, so the MXCSR doesn't matter */
+KERNEL_LINKAGE int KERNEL(__softfp_half_extend)(uint32_t z[], const uint16_t x[], size_t n) {
+    return half_extend_loop(z, x, n);
+}
+
+KERNEL_LINKAGE int KERNEL(__softfp_half_trunc)(uint16_t z[], const uint32_t x[], size_t n, int rm) {
+    unsigned int csr = mxcsr_enter(rm);
+    int status = half_trunc_loop(z, x, n, rm);
+
+    return status | mxcsr_leave(csr);
+}
+
+#if defined SOFTFP_DISPATCH && !defined SOFTFP_VARIANT
+KERNEL_DISPATCH_AVX2(int, __softfp_half_add, (uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm));
+KERNEL_DISPATCH_AVX2(int, __softfp_half_sub, (uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm));
+KERNEL_DISPATCH_AVX2(int, __softfp_half_mul, (uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm));
+KERNEL_DISPATCH_AVX2(int, __softfp_half_div, (uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm));
+KERNEL_DISPATCH_AVX2(int, __softfp_half_extend, (uint32_t z[], const uint16_t x[], size_t n));
+KERNEL_DISPATCH_AVX2(int, __softfp_half_trunc, (uint16_t z[], const uint32_t x[], size_t n, int rm));
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "misc.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * lane-parallel kernels for batches of binary16 values. Each value is widened to binary32, where the operation is
+ * performed by the FPU in the requested rounding mode, and the result is rounded to binary16 in the same mode. Since
+ * binary32 has more than 2 * 11 + 2 significant bits, the intermediate rounding is innocuous and the results (and
+ * exceptions) are the same as those of the scalar implementation. The kernels use SSE2 (4 lanes) or, if available at
+ * runtime, AVX2 (8 lanes), see cpu.h.
+ */
+#if defined __SSE2__ || defined X86_64
+#define SOFTFP_HALF_SIMD 1
+#else
+#define SOFTFP_HALF_SIMD 0
+#endif
+
+#if SOFTFP_HALF_SIMD == 1
+
+/**
+ * calculates `z[i] = x[i] + y[i]` for `0 <= i < n`
+ *
+ * @param z[n] result (may be the same as `x` or `y`)
+ * @param x[n] first operands
+ * @param y[n] second operands
+ * @param n number of elements
+ * @param rm rounding mode
+ * @return the exceptions raised by any of the operations (`SOFTFP_STATUS_*`)
+ */
+int __softfp_half_add(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm);
+
+/* calculates `z[i] = x[i] - y[i]` for `0 <= i < n` (see __softfp_half_add) */
+int __softfp_half_sub(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm);
+
+/* calculates `z[i] = x[i] * y[i]` for `0 <= i < n` (see __softfp_half_add) */
+int __softfp_half_mul(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm);
+
+/* calculates `z[i] = x[i] / y[i]` for `0 <= i < n` (see __softfp_half_add) */
+int __softfp_half_div(uint16_t z[], const uint16_t x[], const uint16_t y[], size_t n, int rm);
+
+/**
+ * converts `n` binary16 values to binary32 (exact, signaling NaNs are quieted)
+ *
+ * @param z[n] results
+ * @param x[n] binary16 values
+ * @param n number of elements
+ * @return the exceptions raised by any of the conversions (`SOFTFP_STATUS_*`)
+ */
+int __softfp_half_extend(uint32_t z[], const uint16_t x[], size_t n);
+
+/* rounds `n` binary32 values to binary16 (see __softfp_half_add and __softfp_half_extend) */
+int __softfp_half_trunc(uint16_t z[], const uint32_t x[], size_t n, int rm);
+
+#endif
@@ -21,8 +21,12 @@
  * SOFTWARE.
  */
 
+#define SOFTFP_FENV
+#include "softfp.h"
+
 #include "misc.h"
 #include "../lsp.h"
+#include "arith.h"
 
 #include <string.h>
 
@@ -40,37 +44,16 @@ bool __softfp_mem_chk_zero(const void *vp, size_t n) {
     return true;
 }
 
-int32_t __softfp_bitscan(uint32_t *arr, size_t n, bool reverse) {
-    if (reverse)
-        for (size_t i = n; i > 0; --i) {
-            size_t v = arr[i - 1];
-
-            if (!v)
-                continue;
-
-#if defined X86 && !defined X86_NO_LZCNT /* use `bsr` or `lzcnt` instruction */
-            return _bit_scan_reverse(v) + 32 * (i - 1);
-#else
-            for (size_t j = 32; j > 0; --j)
-                if (v & (1 << (j - 1)))
-                    return j - 1 + 32 * (i - 1);
-#endif
-        }
-    else
-        for (size_t i = 0; i < n; ++i) {
-            size_t v = arr[i];
-
-            if (!v)
-                continue;
-
-#if defined X86 && !defined X86_NO_TZCNT /* use `bsf` or `tzcnt` instruction */
-            return _bit_scan_forward(v) + 32 * i;
-#else
-            for (size_t j = 0; j < 32; ++j)
-                if (v & (1 << j))
-                    return j + 32 * i;
-#endif
-        }
+int32_t __softfp_bitscan(const limb_t *arr, size_t n, bool reverse) {
+    if (reverse) {
+        for (size_t i = n; i > 0; --i)
+            if (arr[i - 1])
+                return msb_limb(arr[i - 1]) + LIMB_BITS * (i - 1);
+    } else {
+        for (size_t i = 0; i < n; ++i)
+            if (arr[i])
+                return lsb_limb(arr[i]) + LIMB_BITS * i;
+    }
 
     return -1; // no bit found
 }
@@ -94,98 +77,74 @@ int32_t __softfp_revbitscan(uint8_t *arr, size_t n) {
     return -1; // no bit found
 }
 
-int __softfp_arr_shift(uint32_t *arr, size_t n, int32_t shift) {
+int __softfp_arr_shift(limb_t *arr, size_t n, int32_t shift) {
     if (shift == 0 || !n || !arr)
         return 0;
 
-    if (shift < 0) { // shift right
-        shift = -shift;
-
-        bool sticky = false; // OR of all bits shifted out (except round bit)
-        bool round = false;  // most significand bit shifted out
+    const size_t nbits = LIMB_BITS * n;
 
-        size_t wordshift = shift / 32;
-        size_t bitshift = shift % 32;
-
-        for (size_t i = 0; i < n; ++i) {
-            size_t val = arr[i];
+    if (shift < 0) { // shift right
+        const size_t rshift = -(int64_t) shift;
+        const size_t wordshift = rshift / LIMB_BITS;
+        const size_t bitshift = rshift % LIMB_BITS;
 
-            if ((uint32_t) shift > 32 * (i + 1)) {
-                if (!sticky)
-                    sticky = !!val;
-                continue;
-            }
+        const size_t roundbit = rshift - 1;
 
-            if ((uint32_t) shift > 32 * i) {
-                size_t bits = bitshift ? bitshift - 1 : 31;
+        bool round = roundbit < nbits && (arr[roundbit / LIMB_BITS] >> (roundbit % LIMB_BITS)) & 1;
+        bool sticky = false; // OR of all bits shifted out (except round bit)
 
-                round = !!(val & 1 << bits);
+        const size_t stickybits = MIN(roundbit, nbits);
 
-                if (!sticky)
-                    sticky = !!(val & ((1 << bits) - 1));
+        for (size_t i = 0; i < stickybits / LIMB_BITS && !sticky; ++i)
+            sticky = arr[i] != 0;
 
-                if (bitshift)
-                    arr[i - wordshift] = val >> bitshift;
+        if (!sticky && stickybits % LIMB_BITS)
+            sticky = (arr[stickybits / LIMB_BITS] & (((limb_t) 1 << (stickybits % LIMB_BITS)) - 1)) != 0;
 
-                continue;
-            }
+        for (size_t i = 0; i < n; ++i) {
+            limb_t lo = i + wordshift < n ? arr[i + wordshift] : 0;
+            limb_t hi = i + wordshift + 1 < n ? arr[i + wordshift + 1] : 0;
 
-            if (bitshift) {
-                arr[i - wordshift - 1] |= val << (32 - bitshift);
-                arr[i - wordshift - 0] = val >> bitshift;
-            } else
-                arr[i - wordshift] = val;
+            arr[i] = bitshift ? (lo >> bitshift) | (hi << (LIMB_BITS - bitshift)) : lo;
         }
 
-        if (bitshift)
-            arr[n - wordshift - 1] &= (1 << (32 - bitshift)) - 1;
-
-        for (size_t i = 0; i < wordshift; ++i)
-            arr[n - i - 1] = 0;
-
         return (sticky ? BIT_STICKY : 0) | (round ? BIT_ROUND : 0) | ((arr[0] & 1) ? BIT_GUARD : 0);
-    } else {                              // shift left
-        if ((uint32_t) shift >= 32 * n) { // shifting more bits than available
-            memset(arr, 0, n * sizeof(uint32_t));
+    } else {                            // shift left
+        if ((size_t) shift >= nbits) { // shifting more bits than available
+            memset(arr, 0, n * sizeof(limb_t));
             return 0;
         }
 
-        size_t wordshift = shift / 32;
-        size_t bitshift = shift % 32;
+        const size_t wordshift = shift / LIMB_BITS;
+        const size_t bitshift = shift % LIMB_BITS;
 
-        for (size_t i = wordshift; i < n; ++i) {
-            size_t val = arr[n - i - 1];
+        for (size_t i = n; i > 0; --i) {
+            size_t j = i - 1;
 
-            if (bitshift) {
-                arr[n - i + wordshift - 1] = val << bitshift;
+            limb_t hi = j >= wordshift ? arr[j - wordshift] : 0;
+            limb_t lo = j >= wordshift + 1 ? arr[j - wordshift - 1] : 0;
 
-                if (i != wordshift)
-                    arr[n - i + wordshift - 0] |= val >> (32 - bitshift);
-            } else
-                arr[n - i + wordshift - 1] = val;
+            arr[j] = bitshift ? (hi << bitshift) | (lo >> (LIMB_BITS - bitshift)) : hi;
         }
 
-        for (size_t i = 0; i < wordshift; ++i)
-            arr[i] = 0;
-
         return 0;
     }
 }
 
-bool __softfp_should_round(bool sign, int rounding_mode) {
-    bool guard = !!(rounding_mode & BIT_GUARD);
-    bool round = !!(rounding_mode & BIT_ROUND);
-    bool sticky = !!(rounding_mode & BIT_STICKY);
+bool __softfp_should_round(bool sign, int round, int rm) {
+    bool guard = !!(round & BIT_GUARD);
+    bool half = !!(round & BIT_ROUND);
+    bool sticky = !!(round & BIT_STICKY);
 
-    switch (fegetround()) {
+    switch (rm) {
         case FE_TONEAREST: // round to nearest, ties to even
-            return (round && sign) || (guard && round);
+            return half && (sticky || guard);
 
         case FE_DOWNWARD: // toward -inf
-            return sign && (round || sticky);
+            return sign && (half || sticky);
 
         case FE_UPWARD: // toward +inf
-            return !sign && (round || sticky);
+            return !sign && (half || sticky);
 
         case FE_TOWARDZERO: // toward 0
         default:
@@ -193,22 +152,135 @@ bool __softfp_should_round(bool sign, int rounding_mode) {
     }
 }
 
-int __softfp_arr_inc(uint32_t *arr, size_t n) {
-    uint8_t carry = 1;
-    for (size_t i = 0; i < n; ++i) {
-        uint32_t out;
-#ifdef X86
-        carry = _addcarry_u32(carry, arr[i], 0, &out);
-#else
-        out = arr[i];
+/* merges the rounding bits of a right shift with the rounding bits of the bits that were already discarded */
+static inline int merge_round(int shifted, int discarded) {
+    bool sticky = (shifted & BIT_STICKY) || (discarded & (BIT_ROUND | BIT_STICKY));
+    return (shifted & BIT_ROUND) | (sticky ? BIT_STICKY : 0);
+}
+
+/*
+ * checks whether `f` (with the most significant bit at `msb`) would carry into bit `F + 1` when rounded to `F + 1` bits
+ * with an unbounded exponent range (used for detecting tininess after rounding)
+ */
+static bool rounds_up_to_next_binade(const limb_t f[], size_t n, int32_t msb, int round, bool sign, int rm, int32_t F) {
+    limb_t tmp[SOFTFP_MUL_MAX_LIMBS];
+
+    if (n > SOFTFP_MUL_MAX_LIMBS || msb < F)
+        return false;
+
+    memcpy(tmp, f, n * sizeof(limb_t));
+    round = merge_round(__softfp_arr_shift(tmp, n, -(msb - F)), round);
+
+    if (!__softfp_should_round(sign, round | ((tmp[0] & 1) ? BIT_GUARD : 0), rm))
+        return false;
+
+    __softfp_arr_inc(tmp, n);
+
+    return __softfp_bitscan(tmp, n, true) > F;
+}
 
-        if (carry) {
-            ++out;
-            if (out)
-                carry = 0;
+int __softfp_round(limb_t f[], size_t n, int32_t *e, bool sign, int round, int rm, int32_t F, int32_t emin,
+                   int32_t emax) {
+    int32_t msb = __softfp_bitscan(f, n, true);
+
+    if (msb < 0 && !(round & (BIT_ROUND | BIT_STICKY))) { // exact zero
+        *e = emin - 1;
+        return 0;
+    }
+
+    int32_t shift = msb < 0 ? 0 : msb - F;
+    int32_t exp = *e + shift;
+    int flags = 0;
+
+    round &= BIT_ROUND | BIT_STICKY;
+
+    bool tiny = msb >= 0 && exp < emin;
+
+    if (tiny && exp == emin - 1 && rounds_up_to_next_binade(f, n, msb, round, sign, rm, F))
+        tiny = false;
+
+    if (exp < emin) { // denormal result
+        shift += emin - exp;
+        exp = emin;
+    }
+
+    if (shift > 0)
+        round = merge_round(__softfp_arr_shift(f, n, -shift), round);
+    else if (shift < 0) {
+        __softfp_arr_shift(f, n, -shift);
+
+        /* only the round bit can be recovered, the sticky bits would have to be known exactly */
+        if (round & BIT_ROUND)
+            f[(-shift - 1) / LIMB_BITS] |= (limb_t) 1 << ((-shift - 1) % LIMB_BITS);
+
+        round &= BIT_STICKY;
+    }
+
+    if (round) {
+        flags |= SOFTFP_STATUS_INEXACT;
+
+        if (tiny)
+            flags |= SOFTFP_STATUS_UNDERFLOW;
+
+        if (__softfp_should_round(sign, round | ((f[0] & 1) ? BIT_GUARD : 0), rm) && __softfp_arr_inc(f, n) == 0 &&
+            __softfp_bitscan(f, n, true) > F) {
+            __softfp_arr_shift(f, n, -1); // carry into the next binade (the shifted out bit is zero)
+            ++exp;
         }
-#endif
-        arr[i] = out;
     }
+
+    if (msb < 0 && __softfp_bitscan(f, n, true) < 0) // rounded to zero
+        exp = emin - 1;
+
+    if (exp > emax) { // overflow
+        flags |= SOFTFP_STATUS_OVERFLOW | SOFTFP_STATUS_INEXACT;
+
+        memset(f, 0, n * sizeof(limb_t));
+
+        if (rm == FE_TONEAREST || (rm == FE_UPWARD && !sign) || (rm == FE_DOWNWARD && sign))
+            exp = emax + 1; // infinity
+        else {
+            exp = emax; // largest finite value
+
+            for (int32_t i = 0; i <= F; ++i)
+                f[i / LIMB_BITS] |= (limb_t) 1 << (i % LIMB_BITS);
+        }
+    }
+
+    *e = exp;
+    return flags;
+}
+
+void __softfp_merge_status(uint8_t status) {
+    int excepts = 0;
+
+    if (status & SOFTFP_STATUS_INVALID)
+        excepts |= FE_INVALID;
+
+    if (status & SOFTFP_STATUS_DENORM)
+        excepts |= FE_DENORM;
+
+    if (status & SOFTFP_STATUS_DIVBYZERO)
+        excepts |= FE_DIVBYZERO;
+
+    if (status & SOFTFP_STATUS_OVERFLOW)
+        excepts |= FE_OVERFLOW;
+
+    if (status & SOFTFP_STATUS_UNDERFLOW)
+        excepts |= FE_UNDERFLOW;
+
+    if (status & SOFTFP_STATUS_INEXACT)
+        excepts |= FE_INEXACT;
+
+    if (excepts)
+        feraiseexcept(excepts);
+}
+
+int __softfp_arr_inc(limb_t *arr, size_t n) {
+    uint8_t carry = 1;
+
+    for (size_t i = 0; i < n && carry; ++i)
+        arr[i] = addcarry(arr[i], 0, &carry);
+
     return carry;
 }
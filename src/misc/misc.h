@@ -41,6 +41,24 @@
 #define X86 1
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define X86_64 1
+#endif
+
+/*
+ * multi-word integers are stored as arrays of limbs (least significant limb first).
+ * 64-bit limbs are used if the target supports 64x64->128 bit multiplication (`mulx` or `unsigned __int128`).
+ */
+#if defined(__SIZEOF_INT128__) && !defined(SOFTFP_LIMB32)
+#define LIMB_BITS 64
+typedef uint64_t limb_t;
+__extension__ typedef unsigned __int128 dlimb_t;
+#else
+#define LIMB_BITS 32
+typedef uint32_t limb_t;
+typedef uint64_t dlimb_t;
+#endif
+
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
@@ -50,12 +68,14 @@
 #define BITS_TO_BYTES(bits) CEILDIV((bits), 8)
 #define BYTES_TO_WORDS(bytes) CEILDIV((bytes), 4)
 #define BITS_TO_WORDS(bits) CEILDIV((bits), 32)
+#define BYTES_TO_LIMBS(bytes) CEILDIV((bytes), LIMB_BITS / 8)
+#define BITS_TO_LIMBS(bits) CEILDIV((bits), LIMB_BITS)
 
 #define ARRAY_MSB(arr) __softfp_bitscan((arr), sizeof(arr) / sizeof *(arr), true)
 #define ARRAY_LSB(arr) __softfp_bitscan((arr), sizeof(arr) / sizeof *(arr), false)
 
-// forward/reverse bitscan (LSB/MSB) array of n words
-int32_t __softfp_bitscan(uint32_t *arr, size_t n, bool reverse);
+// forward/reverse bitscan (LSB/MSB) array of n limbs
+int32_t __softfp_bitscan(const limb_t *arr, size_t n, bool reverse);
 
 // reverse bitscan (MSB) array of n bytes
 int32_t __softfp_revbitscan(uint8_t *arr, size_t n);
@@ -67,20 +87,55 @@ int32_t __softfp_revbitscan(uint8_t *arr, size_t n);
 #define BIT_ROUND (1 << 1)
 #define BIT_STICKY (1 << 0)
 
-int __softfp_arr_shift(uint32_t *arr, size_t n, int32_t shift);
+int __softfp_arr_shift(limb_t *arr, size_t n, int32_t shift);
 
 #define MEM_IS_ZERO(mem, n) __softfp_mem_chk_zero((mem), (n))
 #define ARRAY_IS_ZERO(arr) MEM_IS_ZERO((arr), sizeof(arr))
 
 bool __softfp_mem_chk_zero(const void *vp, size_t n);
 
-#define SHOULD_ROUND(sign, round) __softfp_should_round((sign), (round))
+#define SHOULD_ROUND(sign, round, rm) __softfp_should_round((sign), (round), (rm))
 
-bool __softfp_should_round(bool sign, int round);
+/* returns true if the magnitude has to be incremented when rounding according to `rm` */
+bool __softfp_should_round(bool sign, int round, int rm);
+
+/**
+ * rounds the value `f * 2^(e - F)` to `F + 1` significant bits according to the rounding mode `rm`. Afterwards, the
+ * J-bit is at bit `F` (or cleared for denormal results, where `e = emin`). Overflows produce either infinity
+ * (`e = emax + 1`, `f = 0`) or the largest finite value, depending on `rm`.
+ *
+ * @param f[n] significand
+ * @param e exponent
+ * @param sign sign of the value
+ * @param round rounding bits of the bits below `f[0]` which were already discarded
+ * @param rm rounding mode
+ * @return the raised exceptions (`SOFTFP_STATUS_INEXACT`, `SOFTFP_STATUS_OVERFLOW` and/or `SOFTFP_STATUS_UNDERFLOW`)
+ */
+int __softfp_round(limb_t f[], size_t n, int32_t *e, bool sign, int round, int rm, int32_t F, int32_t emin,
+                   int32_t emax);
 
 #define ARRAY_INCREMENT(arr) __softfp_arr_inc((arr), sizeof(arr) / sizeof *(arr))
 
-int __softfp_arr_inc(uint32_t *arr, size_t n);
+int __softfp_arr_inc(limb_t *arr, size_t n);
+
+/* ORs the exceptions `flags` (`SOFTFP_STATUS_*`) into the status word `status` of the current operation */
+#define STATUS_RAISE(flags) (*status |= (uint8_t) (flags))
+
+/*
+ * evaluates `expr`, which may refer to a fresh status word `status`, merges the exceptions raised by it into the
+ * floating-point environment and returns its value
+ */
+#define STATUS_RETURN(type, expr)                                                                                      \
+    do {                                                                                                               \
+        uint8_t __status = 0;                                                                                          \
+        uint8_t *status = &__status;                                                                                   \
+        type __ret = (expr);                                                                                           \
+                                                                                                                       \
+        if (__status)                                                                                                  \
+            __softfp_merge_status(__status);                                                                           \
+                                                                                                                       \
+        return __ret;                                                                                                  \
+    } while (0)
 
 #ifndef SOFTFP_HAS_FENV
 #include <fenv.h>
@@ -0,0 +1,57 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "misc.h"
+
+#include <immintrin.h>
+
+/*
+ * helpers for the SIMD kernels (half.c, convert.c), which let the FPU do the rounding. mxcsr_enter masks all
+ * exceptions, clears the flags, FTZ and DAZ, and sets the requested rounding mode. mxcsr_leave restores the previous
+ * MXCSR and returns the exceptions raised in between as `SOFTFP_STATUS_*` bits (the MXCSR flags have the same layout).
+ * The kernel code between these calls must be in a function which is not inlined, so that the compiler cannot move it
+ * across the MXCSR accesses.
+ */
+
+#define MXCSR_FLAGS 0x3F
+#define MXCSR_MASKS 0x1F80
+#define MXCSR_RC_SHIFT 13
+
+static inline unsigned int mxcsr_enter(int rm) {
+    unsigned int rc = rm == FE_DOWNWARD ? 1 : rm == FE_UPWARD ? 2 : rm == FE_TOWARDZERO ? 3 : 0;
+    unsigned int csr = _mm_getcsr();
+
+    _mm_setcsr((csr & ~0xFFFFu) | MXCSR_MASKS | (rc << MXCSR_RC_SHIFT));
+
+    return csr;
+}
+
+static inline int mxcsr_leave(unsigned int csr) {
+    unsigned int raised = _mm_getcsr() & MXCSR_FLAGS;
+
+    _mm_setcsr(csr);
+
+    return (int) raised;
+}
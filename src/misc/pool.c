@@ -0,0 +1,211 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "pool.h"
+
+#include "softfp.h"
+
+#ifdef SOFTFP_THREADS
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define MAX_THREADS 64
+#define CACHE_LINE 64
+
+/* the chunks `next` to `end - 1`, which have not been claimed yet */
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_size_t next;
+    size_t end;
+} share_t;
+
+typedef struct {
+    softfp_task_t task;
+    void *arg;
+    size_t n;
+    size_t chunk; /* elements per chunk */
+    unsigned nparts;
+    atomic_uint status;
+    share_t share[MAX_THREADS]; /* one per participant, the caller has the first one */
+} job_t;
+
+typedef struct {
+    pthread_t thread;
+    unsigned id;
+    unsigned long seen; /* generation of the last job */
+} worker_t;
+
+static struct {
+    pthread_mutex_t busy; /* held while a job is running or the pool is resized */
+    pthread_mutex_t lock; /* protects the fields below */
+    pthread_cond_t wake;  /* signaled when a job is posted */
+    pthread_cond_t done;  /* signaled when the last worker is done with the job */
+    job_t *job;
+    unsigned long generation;
+    unsigned pending; /* number of workers which are not done with the current job */
+    unsigned nworkers;
+    atomic_uint nthreads; /* number of participants (including the caller) */
+} pool = {
+    .busy = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+    .nthreads = 1,
+};
+
+static worker_t workers[MAX_THREADS];
+
+/* processes the own share of the job first, then steals chunks from the other participants */
+static void run(job_t *job, unsigned id) {
+    uint8_t status = 0;
+
+    for (unsigned k = 0; k < job->nparts; ++k) {
+        share_t *share = &job->share[(id + k) % job->nparts];
+        size_t c;
+
+        while ((c = atomic_fetch_add_explicit(&share->next, 1, memory_order_relaxed)) < share->end) {
+            size_t lo = c * job->chunk;
+            size_t hi = job->n - lo > job->chunk ? lo + job->chunk : job->n;
+
+            job->task(job->arg, lo, hi, &status);
+        }
+    }
+
+    if (status)
+        atomic_fetch_or(&job->status, status);
+}
+
+static void *worker(void *arg) {
+    worker_t *self = arg;
+
+    pthread_mutex_lock(&pool.lock);
+
+    for (;;) {
+        while (pool.generation == self->seen)
+            pthread_cond_wait(&pool.wake, &pool.lock);
+
+        self->seen = pool.generation;
+        job_t *job = pool.job;
+
+        pthread_mutex_unlock(&pool.lock);
+
+        if (self->id < job->nparts)
+            run(job, self->id);
+
+        pthread_mutex_lock(&pool.lock);
+
+        if (--pool.pending == 0)
+            pthread_cond_signal(&pool.done);
+    }
+
+    return NULL;
+}
+#endif
+
+int __softfp_set_threads(unsigned nthreads) {
+#ifdef SOFTFP_THREADS
+    if (nthreads > MAX_THREADS)
+        nthreads = MAX_THREADS;
+
+    pthread_mutex_lock(&pool.busy);
+    pthread_mutex_lock(&pool.lock);
+
+    /* the workers are never terminated, surplus ones just sit out the jobs */
+    while (pool.nworkers + 1 < nthreads) {
+        worker_t *w = &workers[pool.nworkers + 1];
+
+        w->id = pool.nworkers + 1;
+        w->seen = pool.generation;
+
+        if (pthread_create(&w->thread, NULL, worker, w))
+            break;
+
+        pthread_detach(w->thread);
+        ++pool.nworkers;
+    }
+
+    if (nthreads > pool.nworkers + 1)
+        nthreads = pool.nworkers + 1;
+
+    atomic_store(&pool.nthreads, nthreads ? nthreads : 1);
+
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.busy);
+
+    return (int) atomic_load(&pool.nthreads);
+#else
+    (void) nthreads;
+    return 1;
+#endif
+}
+
+uint8_t __softfp_parallel_for(size_t n, size_t size, softfp_task_t task, void *arg) {
+    uint8_t status = 0;
+
+#ifdef SOFTFP_THREADS
+    size_t chunk = size && size < SOFTFP_POOL_CHUNK ? SOFTFP_POOL_CHUNK / size : 1;
+    size_t nchunks = n / chunk + (n % chunk != 0);
+
+    /* the pool serves one batch at a time, concurrent batches are processed by their calling threads */
+    if (nchunks > 1 && atomic_load_explicit(&pool.nthreads, memory_order_relaxed) > 1 &&
+        !pthread_mutex_trylock(&pool.busy)) {
+        unsigned nparts = atomic_load(&pool.nthreads);
+
+        if (nparts > nchunks)
+            nparts = nchunks;
+
+        job_t job = {.task = task, .arg = arg, .n = n, .chunk = chunk, .nparts = nparts};
+
+        atomic_init(&job.status, 0);
+
+        for (unsigned p = 0; p < nparts; ++p) {
+            atomic_init(&job.share[p].next, nchunks * p / nparts);
+            job.share[p].end = nchunks * (p + 1) / nparts;
+        }
+
+        pthread_mutex_lock(&pool.lock);
+        pool.job = &job;
+        pool.pending = pool.nworkers;
+        ++pool.generation;
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+
+        run(&job, 0);
+
+        pthread_mutex_lock(&pool.lock);
+
+        while (pool.pending)
+            pthread_cond_wait(&pool.done, &pool.lock);
+
+        pthread_mutex_unlock(&pool.lock);
+        pthread_mutex_unlock(&pool.busy);
+
+        return (uint8_t) atomic_load(&job.status);
+    }
+#else
+    (void) size;
+#endif
+
+    task(arg, 0, n, &status);
+    return status;
+}
@@ -0,0 +1,83 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * opt-in thread pool for the batch functions. `__softfp_parallel_for` splits the index range of a batch into chunks of
+ * roughly SOFTFP_POOL_CHUNK bytes, which are distributed across the calling thread and a persistent pool of worker
+ * threads. Every participant starts with a contiguous share of the chunks and, once it has processed them, steals the
+ * remaining chunks of the others, so that regions which are more expensive (e.g. denormals) do not hold up the call.
+ *
+ * The task functions receive the rounding mode from the caller (see `softfp_batch_t`) and report their exceptions in
+ * a status word, which the caller merges into its own floating-point environment. Thus, the results and exceptions are
+ * the same as if the batch was processed by a single thread.
+ *
+ * The pool is disabled until `__softfp_set_threads` is called with more than one thread. Without SOFTFP_THREADS (or if
+ * the pool is in use by another thread), the whole range is processed by the calling thread.
+ */
+
+#ifndef SOFTFP_POOL_CHUNK
+#define SOFTFP_POOL_CHUNK 16384 /* bytes per chunk (of the widest array) */
+#endif
+
+/* processes the elements `lo` to `hi - 1` of a batch, ORing the exceptions into `*status` */
+typedef void (*softfp_task_t)(void *arg, size_t lo, size_t hi, uint8_t *status);
+
+/* operands of a batch function (the element types depend on the function) */
+typedef struct {
+    void *dst;
+    const void *a;
+    const void *b;
+    const void *c;
+    int rm; /* rounding mode of the caller */
+} softfp_batch_t;
+
+/**
+ * calls `task` for all elements `0 <= i < n`, using the thread pool if it is enabled and the batch is large enough
+ *
+ * @param n number of elements
+ * @param size size of an element (of the widest array) in bytes, determines the chunk size
+ * @param task processes a range of elements
+ * @param arg argument for `task`
+ * @return the exceptions raised by any of the tasks (`SOFTFP_STATUS_*`)
+ */
+uint8_t __softfp_parallel_for(size_t n, size_t size, softfp_task_t task, void *arg);
+
+/* name of the chunk function of the batch function `name` (expanded first, so that it is unique per format) */
+#define FBATCH_CHUNK(name) FBATCH_XCHUNK(name)
+#define FBATCH_XCHUNK(name) name##_chunk
+
+/* processes the batch with the chunk function of `name`, `size` is the size of the widest element */
+#define FBATCH_RUN(name, size, ...)                                                                                    \
+    do {                                                                                                               \
+        softfp_batch_t job = {__VA_ARGS__};                                                                            \
+        uint8_t status = __softfp_parallel_for(n, (size), FBATCH_CHUNK(name), &job);                                   \
+                                                                                                                       \
+        if (status)                                                                                                    \
+            __softfp_merge_status(status);                                                                             \
+    } while (0)
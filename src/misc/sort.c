@@ -0,0 +1,257 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sort.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SOFTFP_THREADS
+#include <pthread.h>
+#include <unistd.h>
+
+#define MIN_PARALLEL 65536 /* smallest array that is sorted by multiple threads */
+#define MIN_CHUNK 32768    /* smallest number of elements per thread */
+#define MAX_THREADS 64
+#else
+#define MAX_THREADS 1
+#endif
+
+typedef struct {
+    unsigned char *base;
+    size_t n;
+    size_t size;
+    size_t keysize;
+    softfp_sortkey_t key;
+
+    size_t stride; /* size of a record (key, padding and element) */
+    size_t offset; /* offset of the element within a record */
+    unsigned char *buf[2];
+
+    unsigned nthreads;
+    size_t count[MAX_THREADS][256]; /* histogram of a chunk, then the output position of each bucket */
+    bool skip;                      /* all keys have the same byte in the current pass */
+
+#ifdef SOFTFP_THREADS
+    pthread_mutex_t lock;
+    pthread_barrier_t barrier;
+#endif
+} sort_job_t;
+
+typedef struct {
+    sort_job_t *job;
+    unsigned tid;
+} sort_thread_t;
+
+static inline void sync_threads(sort_job_t *job) {
+#ifdef SOFTFP_THREADS
+    if (job->nthreads > 1)
+        pthread_barrier_wait(&job->barrier);
+#else
+    (void) job;
+#endif
+}
+
+/* copies the records of `src` to their bucket in `dst`, the common record sizes have their own loop */
+#define SCATTER(stride)                                                                                                \
+    for (const unsigned char *rec = src; rec != end; rec += (stride))                                                  \
+        memcpy(dst + pos[rec[digit]]++ * (stride), rec, (stride));
+
+static void scatter(unsigned char *dst, const unsigned char *src, const unsigned char *end, size_t stride,
+                    size_t digit, size_t pos[256]) {
+    switch (stride) {
+    case 4: SCATTER(4) break;
+    case 8: SCATTER(8) break;
+    case 16: SCATTER(16) break;
+    case 32: SCATTER(32) break;
+    case 64: SCATTER(64) break;
+    default: SCATTER(stride) break;
+    }
+}
+
+static void sort_chunk(sort_job_t *job, unsigned tid) {
+    size_t lo = job->n * tid / job->nthreads;
+    size_t hi = job->n * (tid + 1) / job->nthreads;
+    size_t stride = job->stride;
+    size_t *count = job->count[tid];
+    unsigned cur = 0;
+
+    for (size_t i = lo; i < hi; ++i) {
+        unsigned char *rec = job->buf[0] + i * stride;
+        const unsigned char *elem = job->base + i * job->size;
+
+        job->key(rec, elem);
+        memcpy(rec + job->offset, elem, job->size);
+    }
+
+    for (size_t digit = 0; digit < job->keysize; ++digit) {
+        const unsigned char *src = job->buf[cur];
+
+        memset(count, 0, 256 * sizeof *count);
+
+        for (size_t i = lo; i < hi; ++i)
+            ++count[src[i * stride + digit]];
+
+        sync_threads(job);
+
+        if (tid == 0) {
+            size_t pos = 0;
+            job->skip = false;
+
+            for (unsigned b = 0; b < 256; ++b) {
+                size_t total = 0;
+
+                for (unsigned t = 0; t < job->nthreads; ++t) {
+                    size_t c = job->count[t][b];
+                    job->count[t][b] = pos + total;
+                    total += c;
+                }
+
+                if (total == job->n)
+                    job->skip = true;
+
+                pos += total;
+            }
+        }
+
+        sync_threads(job);
+
+        if (job->skip)
+            continue;
+
+        scatter(job->buf[cur ^ 1], src + lo * stride, src + hi * stride, stride, digit, count);
+        cur ^= 1;
+
+        sync_threads(job); /* the next pass reads records written by other threads */
+    }
+
+    for (size_t i = lo; i < hi; ++i)
+        memcpy(job->base + i * job->size, job->buf[cur] + i * stride + job->offset, job->size);
+}
+
+#ifdef SOFTFP_THREADS
+static void *sort_thread(void *arg) {
+    sort_thread_t *thread = arg;
+    sort_job_t *job = thread->job;
+
+    /* wait until the number of threads is known */
+    pthread_mutex_lock(&job->lock);
+    pthread_mutex_unlock(&job->lock);
+
+    sort_chunk(job, thread->tid);
+    return NULL;
+}
+
+static unsigned count_threads(size_t n) {
+    if (n < MIN_PARALLEL)
+        return 1;
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = n / MIN_CHUNK;
+
+    if (ncpu > 0 && (size_t) ncpu < nthreads)
+        nthreads = ncpu;
+
+    return nthreads > MAX_THREADS ? MAX_THREADS : nthreads;
+}
+#endif
+
+int __softfp_radix_sort(void *base, size_t n, size_t size, size_t keysize, softfp_sortkey_t key) {
+    if (n < 2)
+        return 0;
+
+    sort_job_t *job = malloc(sizeof *job);
+
+    if (!job)
+        return -1;
+
+    job->base = base;
+    job->n = n;
+    job->size = size;
+    job->keysize = keysize;
+    job->key = key;
+
+    /* round the record size up to a power of two, the element is stored at the end */
+    job->stride = 4;
+    while (job->stride < keysize + size)
+        job->stride *= 2;
+
+    job->offset = job->stride - size;
+
+    job->buf[0] = n > SIZE_MAX / 2 / job->stride ? NULL : malloc(2 * n * job->stride);
+
+    if (!job->buf[0]) {
+        free(job);
+        return -1;
+    }
+
+    job->buf[1] = job->buf[0] + n * job->stride;
+    job->nthreads = 1;
+
+#ifdef SOFTFP_THREADS
+    unsigned nthreads = count_threads(n);
+
+    if (nthreads > 1) {
+        pthread_t threads[MAX_THREADS];
+        sort_thread_t args[MAX_THREADS];
+        unsigned created = 0;
+
+        pthread_mutex_init(&job->lock, NULL);
+        pthread_mutex_lock(&job->lock);
+
+        /* the calling thread processes the first chunk */
+        while (created + 1 < nthreads) {
+            args[created] = (sort_thread_t) {job, created + 1};
+
+            if (pthread_create(&threads[created], NULL, sort_thread, &args[created]))
+                break;
+
+            ++created;
+        }
+
+        job->nthreads = created + 1;
+
+        if (job->nthreads > 1)
+            pthread_barrier_init(&job->barrier, NULL, job->nthreads);
+
+        pthread_mutex_unlock(&job->lock);
+
+        sort_chunk(job, 0);
+
+        for (unsigned t = 0; t < created; ++t)
+            pthread_join(threads[t], NULL);
+
+        if (job->nthreads > 1)
+            pthread_barrier_destroy(&job->barrier);
+
+        pthread_mutex_destroy(&job->lock);
+    } else
+#endif
+        sort_chunk(job, 0);
+
+    free(job->buf[0]);
+    free(job);
+    return 0;
+}
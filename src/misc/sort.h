@@ -0,0 +1,52 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/*
+ * stable LSD radix sort on order-preserving keys. Every element is stored next to its key (an unsigned little-endian
+ * integer of `keysize` bytes), the records are then distributed by one key byte per pass, starting at the least
+ * significant one. Passes where all keys share the same byte are skipped.
+ *
+ * With SOFTFP_THREADS, large arrays are split into contiguous chunks, one per thread: each thread counts the key bytes
+ * of its chunk, the counts are turned into per-thread output positions and each thread then scatters its chunk in
+ * order, so that the result is the same (and just as stable) as with a single thread.
+ */
+
+/* writes the key of the element `elem` to `key` */
+typedef void (*softfp_sortkey_t)(void *key, const void *elem);
+
+/**
+ * sorts `n` elements of `size` bytes each in ascending order of their keys. Elements with equal keys keep their
+ * relative order.
+ *
+ * @param base[n] the elements
+ * @param n number of elements
+ * @param size size of an element in bytes
+ * @param keysize size of a key in bytes
+ * @param key calculates the key of an element
+ * @return 0 on success, -1 if the scratch memory could not be allocated (the elements are left unchanged)
+ */
+int __softfp_radix_sort(void *base, size_t n, size_t size, size_t keysize, softfp_sortkey_t key);
@@ -0,0 +1,40 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lsp.h"
+#include "misc/sort.h"
+
+/*
+ * sorting in IEEE 754 totalOrder. Each format provides `fsortkey` (binary/sortkey.h or decimal/sortkey.h), which maps
+ * a number to an unsigned little-endian integer of FBITS / 8 bytes, such that comparing the keys is the same as
+ * comparing the numbers. The keys are then sorted by the radix sort in misc/sort.c.
+ */
+
+__FPFUN_LINKAGE void fsortkey_n(void *keys, const fsrc_t *a, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        fsortkey((unsigned char *) keys + i * (FBITS / 8), &a[i]);
+}
+
+__FPFUN_LINKAGE int fsort_n(fsrc_t *a, size_t n) {
+    return __softfp_radix_sort(a, n, sizeof *a, FBITS / 8, fsortkey);
+}
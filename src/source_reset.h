@@ -0,0 +1,57 @@
+/* MIT License
+ *
+ * Copyright (c) 2024 Thomas Kasper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* undefines the current source (and target) format, so that the next source config can be included */
+
+#include "binary/target_reset.h"
+#include "decimal/target_reset.h"
+
+#undef TDEFINED
+
+#ifdef CONV_TGT
+#undef CONV_TGT
+#undef CONV_TRUNC
+#undef fconv
+#undef fconv_st
+#undef fconv_n
+#endif
+
+#undef CONV_SRC
+
+#undef FDEFINED
+#undef FDEC
+#undef FCAST_ONLY
+#undef FBITS
+#undef FEXP
+#undef FJBIT
+#undef FFRAC
+#undef FID
+#undef FCID
+#undef FSTDCOMPLEX
+#undef FDPD
+#undef FCOMB
+#undef FSIGN
+
+#undef fsrc_t
+#undef fcomplex_t
+#undef facc_t
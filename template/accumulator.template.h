@@ -0,0 +1,48 @@
+/** @brief initializes the exact accumulator `acc` to zero
+ * The accumulator is a fixed-point number wide enough to
+ * hold any sum of values and products of values without
+ * rounding, so that the result only depends on the set of
+ * terms, but not on their order.
+ */
+void __accinit%I(%A *acc);
+
+/** @brief adds `a` to the exact accumulator `acc` */
+void __accadd%I(%A *acc, %T a);
+
+/** @brief adds `a * b` to the exact accumulator `acc` (without rounding the product) */
+void __accmadd%I(%A *acc, %T a, %T b);
+
+/** @brief adds the exact accumulator `src` to `acc`
+ * This allows summing parts of an array independently
+ * (e.g. in multiple threads). The result is the same as
+ * if all terms had been added to `acc` directly, as long
+ * as the parts are merged in order.
+ */
+void __accmerge%I(%A *acc, const %A *src);
+
+/** @brief rounds the exact accumulator `acc`
+ * The exceptions of the added terms (e.g. FE_INVALID for
+ * `Inf - Inf` or signaling NaNs) are raised together with
+ * the ones of the rounding.
+ */
+%T __accround%I(const %A *acc);
+
+/** @brief rounds the exact accumulator `acc`, as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T __accround%I_rm(const %A *acc, int rm);
+
+/** @brief rounds the exact accumulator `acc`, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T __accround%I_st(const %A *acc, int rm, uint8_t *status);
+
+/** @brief calculates the correctly rounded sum of `a[i]` for `0 <= i < n` */
+%T __sum%I_n(const %T *a, size_t n);
+
+/** @brief calculates the correctly rounded sum of `a[i] * b[i]` for `0 <= i < n` */
+%T __dot%I_n(const %T *a, const %T *b, size_t n);
@@ -0,0 +1,47 @@
+/** @brief calculates `a * b + c` with a single rounding
+ * The product is not rounded before the addition, so the
+ * result is the exact value of `a * b + c`, rounded once.
+ * `0 * Inf + c` raises FE_INVALID, even if `c` is a quiet
+ * NaN.
+ */
+%T __fma%I4(%T a, %T b, %T c);
+
+/** @brief calculates `a * b + c` with a single rounding, rounding as specified by `rm` */
+%T __fma%I4_rm(%T a, %T b, %T c, int rm);
+
+/** @brief calculates `a * b + c` with a single rounding, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T __fma%I4_st(%T a, %T b, %T c, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = a[i] * b[i] + c[i]` for `0 <= i < n`
+ * The rounding mode is read and the exceptions are raised
+ * only once per call. `dst` may be the same array as `a`,
+ * `b` or `c`.
+ */
+void __fma%I4_n(%T *dst, const %T *a, const %T *b, const %T *c, size_t n);
+
+/** @brief calculates the square root of `a`
+ * The result is correctly rounded. The square root of
+ * `-0` is `-0`, the square root of any other negative
+ * number raises FE_INVALID.
+ */
+%T __sqrt%I2(%T a);
+
+/** @brief calculates the square root of `a`, rounding as specified by `rm` */
+%T __sqrt%I2_rm(%T a, int rm);
+
+/** @brief calculates the square root of `a`, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T __sqrt%I2_st(%T a, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = sqrt(a[i])` for `0 <= i < n`
+ * The rounding mode is read and the exceptions are raised
+ * only once per call. `dst` may be the same array as `a`.
+ */
+void __sqrt%I2_n(%T *dst, const %T *a, size_t n);
@@ -0,0 +1,17 @@
+/** @brief calculates `(ar[i]+i*ai[i]) * (br[i]+i*bi[i])` for `0 <= i < n`
+ * The real and imaginary parts are stored in `re` and `im`.
+ * The results are the same as those of `__mul%I3`, but the
+ * rounding mode is read and the exceptions are raised only
+ * once per call. `re` and `im` may each be the same array
+ * as one of the operands.
+ */
+void __mul%I3_n(%T *re, %T *im, const %T *ar, const %T *ai, const %T *br, const %T *bi, size_t n);
+
+/** @brief calculates `(ar[i]+i*ai[i]) / (br[i]+i*bi[i])` for `0 <= i < n`
+ * The real and imaginary parts are stored in `re` and `im`.
+ * The results are the same as those of `__div%I3`, but the
+ * rounding mode is read and the exceptions are raised only
+ * once per call. `re` and `im` may each be the same array
+ * as one of the operands.
+ */
+void __div%I3_n(%T *re, %T *im, const %T *ar, const %T *ai, const %T *br, const %T *bi, size_t n);
\ No newline at end of file
@@ -23,6 +23,9 @@
 
 /*** MACHINE GENERATED FILE ***/
 
+/* both BID and DPD are enabled, i.e., the functions are prefixed with `__bid_` or `__dpd_` */
+#define DREPR_BOTH %DB
+
 #ifndef FDEFINED /* as source */
 # define FDEFINED
 
@@ -0,0 +1,254 @@
+/** @brief calculates `a + b`, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Padd%I3_rm(%T a, %T b, int rm);
+
+/** @brief calculates `a + b`, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Padd%I3_st(%T a, %T b, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = a[i] + b[i]` for `0 <= i < n`
+ * The rounding mode is read and the exceptions are raised
+ * only once per call. `dst` may be the same array as `a`
+ * or `b`.
+ */
+void %Padd%I3_n(%T *dst, const %T *a, const %T *b, size_t n);
+
+/** @brief calculates `a - b`, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Psub%I3_rm(%T a, %T b, int rm);
+
+/** @brief calculates `a - b`, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Psub%I3_st(%T a, %T b, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = a[i] - b[i]` for `0 <= i < n`
+ * The rounding mode is read and the exceptions are raised
+ * only once per call. `dst` may be the same array as `a`
+ * or `b`.
+ */
+void %Psub%I3_n(%T *dst, const %T *a, const %T *b, size_t n);
+
+/** @brief calculates `a * b`, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pmul%I3_rm(%T a, %T b, int rm);
+
+/** @brief calculates `a * b`, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pmul%I3_st(%T a, %T b, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = a[i] * b[i]` for `0 <= i < n`
+ * The rounding mode is read and the exceptions are raised
+ * only once per call. `dst` may be the same array as `a`
+ * or `b`.
+ */
+void %Pmul%I3_n(%T *dst, const %T *a, const %T *b, size_t n);
+
+/** @brief calculates `a / b`, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pdiv%I3_rm(%T a, %T b, int rm);
+
+/** @brief calculates `a / b`, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pdiv%I3_st(%T a, %T b, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = a[i] / b[i]` for `0 <= i < n`
+ * The rounding mode is read and the exceptions are raised
+ * only once per call. `dst` may be the same array as `a`
+ * or `b`.
+ */
+void %Pdiv%I3_n(%T *dst, const %T *a, const %T *b, size_t n);
+
+/** @brief calculates `dst[i] = -a[i]` for `0 <= i < n` */
+void %Pneg%I2_n(%T *dst, const %T *a, size_t n);
+
+/** @brief converts `a` into a signed 32-bit integer, using the status word `status`
+ * Instead of raising exceptions in the floating-point
+ * environment, they are ORed into `*status`.
+ */
+int32_t %Pfix%Isi_st(%T a, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into a signed 32-bit integer each
+ * The exceptions are raised only once per call.
+ */
+void %Pfix%Isi_n(int32_t *dst, const %T *a, size_t n);
+
+/** @brief converts `a` into a signed 64-bit integer, using the status word `status`
+ * Instead of raising exceptions in the floating-point
+ * environment, they are ORed into `*status`.
+ */
+int64_t %Pfix%Idi_st(%T a, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into a signed 64-bit integer each
+ * The exceptions are raised only once per call.
+ */
+void %Pfix%Idi_n(int64_t *dst, const %T *a, size_t n);
+
+/** @brief converts `a` into an unsigned 32-bit integer, using the status word `status`
+ * Instead of raising exceptions in the floating-point
+ * environment, they are ORed into `*status`.
+ */
+uint32_t %Pfixuns%Isi_st(%T a, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into an unsigned 32-bit integer each
+ * The exceptions are raised only once per call.
+ */
+void %Pfixuns%Isi_n(uint32_t *dst, const %T *a, size_t n);
+
+/** @brief converts `a` into an unsigned 64-bit integer, using the status word `status`
+ * Instead of raising exceptions in the floating-point
+ * environment, they are ORed into `*status`.
+ */
+uint64_t %Pfixuns%Idi_st(%T a, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into an unsigned 64-bit integer each
+ * The exceptions are raised only once per call.
+ */
+void %Pfixuns%Idi_n(uint64_t *dst, const %T *a, size_t n);
+
+/** @brief converts `a` into a floating-point number, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pfloatsi%I_rm(int32_t a, int rm);
+
+/** @brief converts `a` into a floating-point number, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pfloatsi%I_st(int32_t a, int rm, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into floating-point numbers
+ * The rounding mode is read and the exceptions are raised
+ * only once per call.
+ */
+void %Pfloatsi%I_n(%T *dst, const int32_t *a, size_t n);
+
+/** @brief converts `a` into a floating-point number, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pfloatdi%I_rm(int64_t a, int rm);
+
+/** @brief converts `a` into a floating-point number, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pfloatdi%I_st(int64_t a, int rm, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into floating-point numbers
+ * The rounding mode is read and the exceptions are raised
+ * only once per call.
+ */
+void %Pfloatdi%I_n(%T *dst, const int64_t *a, size_t n);
+
+/** @brief converts `a` into a floating-point number, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pfloatunsi%I_rm(uint32_t a, int rm);
+
+/** @brief converts `a` into a floating-point number, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pfloatunsi%I_st(uint32_t a, int rm, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into floating-point numbers
+ * The rounding mode is read and the exceptions are raised
+ * only once per call.
+ */
+void %Pfloatunsi%I_n(%T *dst, const uint32_t *a, size_t n);
+
+/** @brief converts `a` into a floating-point number, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pfloatundi%I_rm(uint64_t a, int rm);
+
+/** @brief converts `a` into a floating-point number, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pfloatundi%I_st(uint64_t a, int rm, uint8_t *status);
+
+/** @brief converts the `n` elements of `a` into floating-point numbers
+ * The rounding mode is read and the exceptions are raised
+ * only once per call.
+ */
+void %Pfloatundi%I_n(%T *dst, const uint64_t *a, size_t n);
+
+/** @brief converts `a` into a bit-precise integer, using the status word `status`
+ * Instead of raising exceptions in the floating-point
+ * environment, they are ORed into `*status`.
+ */
+void %Pfix%Ibitint_st(void *r, int32_t rprec, %T a, uint8_t *status);
+
+/** @brief converts `a` into a floating-point number, rounding as specified by `rm`
+ * `rm` is the rounding mode (`FE_TONEAREST`, `FE_DOWNWARD`,
+ * `FE_UPWARD` or `FE_TOWARDZERO`) to use instead of the
+ * current one.
+ */
+%T %Pfloatbitint%I_rm(const void *r, int32_t rprec, int rm);
+
+/** @brief converts `a` into a floating-point number, using the status word `status`
+ * `rm` is the rounding mode to use and, instead of raising
+ * exceptions in the floating-point environment, they are
+ * ORed into `*status`.
+ */
+%T %Pfloatbitint%I_st(const void *r, int32_t rprec, int rm, uint8_t *status);
+
+/** @brief calculates `dst[i] = a[i] <=> b[i]` for `0 <= i < n`
+ * The exceptions are raised only once per call.
+ */
+void %Pcmp%I2_n(int *dst, const %T *a, const %T *b, size_t n);
+
+/** @brief calculates the sort keys of `a[i]` for `0 <= i < n`
+ * Each key is an unsigned little-endian integer with
+ * the same size as `%T` (without padding), so that
+ * comparing the keys is the same as comparing the
+ * numbers in IEEE 754 totalOrder. The `i`-th key is
+ * stored at `(char *) keys + i * size`.
+ */
+void %Psortkey%I_n(void *keys, const %T *a, size_t n);
+
+/** @brief sorts `a` in ascending order (IEEE 754 totalOrder)
+ * The sort is stable, i.e. numbers with the same key
+ * (as calculated by `%Psortkey%I_n`) keep their
+ * relative order. Large arrays are sorted by multiple
+ * threads if the library was built with SOFTFP_THREADS.
+ * Returns 0 on success or -1 if the scratch memory
+ * could not be allocated.
+ */
+int %Psort%I_n(%T *a, size_t n);
\ No newline at end of file
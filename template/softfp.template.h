@@ -34,6 +34,7 @@ extern "C" {
 
 /***** TYPE DEFINITIONS *****/
 
+#include <stddef.h>
 #include <stdint.h>
 %typedefs%
 
@@ -41,6 +42,60 @@ extern "C" {
 
 %functions%
 
+/***** EXCEPTION STATUS WORD *****/
+
+/*
+ * The `_st` variants of the functions above don't access the floating-point
+ * environment. Instead, they OR the exceptions they raise into the status word
+ * pointed to by `status`, which can be merged into the floating-point
+ * environment once all operations are done.
+ */
+
+# define SOFTFP_STATUS_INVALID   (1 << 0)
+# define SOFTFP_STATUS_DENORM    (1 << 1) /* nonstandard */
+# define SOFTFP_STATUS_DIVBYZERO (1 << 2)
+# define SOFTFP_STATUS_OVERFLOW  (1 << 3)
+# define SOFTFP_STATUS_UNDERFLOW (1 << 4)
+# define SOFTFP_STATUS_INEXACT   (1 << 5)
+
+/** @brief raises the exceptions in the status word `status`
+ * Raises the exceptions in the status word `status` (a combination
+ * of `SOFTFP_STATUS_*` values) in the floating-point environment,
+ * as if by a single call to `feraiseexcept`.
+ */
+void __softfp_merge_status(uint8_t status);
+
+/***** THREADS *****/
+
+/** @brief sets the number of threads used by the batch functions
+ * Sets the number of threads (including the calling one) which process the
+ * elements of large batches (the `_n` functions). By default, and if
+ * `nthreads` is 0 or 1, every batch is processed by the calling thread. The
+ * worker threads are created on demand and kept until the program exits.
+ * The rounding mode of the calling thread is used by all threads, and the
+ * exceptions they raise are raised in the floating-point environment of the
+ * calling thread, so the results are the same as with a single thread.
+ * Returns the number of threads that will be used, which may be less than
+ * `nthreads` (e.g. 1 if the library was built without SOFTFP_THREADS).
+ */
+int __softfp_set_threads(unsigned nthreads);
+
+/***** DECIMAL ENCODINGS *****/
+
+/** @brief converts `n` decimal64 values from DPD to BID
+ * Converts the `n` decimal64 values at `src`, which are encoded as densely
+ * packed decimal, to the binary integer decimal encoding and stores them at
+ * `dst` (which may be the same as `src`). The values are decoded several at a
+ * time where the CPU supports it. Non-canonical declets and infinities are
+ * canonicalized. No exceptions are raised.
+ */
+void __softfp_dpd_to_bid64(void *dst, const void *src, size_t n);
+
+/** @brief converts `n` decimal128 values from DPD to BID
+ * Same as `__softfp_dpd_to_bid64`, but for decimal128 values.
+ */
+void __softfp_dpd_to_bid128(void *dst, const void *src, size_t n);
+
 %fenv%
 
 # ifdef __cplusplus